@@ -35,6 +35,7 @@
 
 #include "StdWiggler.hpp"
 #include "ANDBF706.hpp"                        //  device class
+#include "memscan.hpp"                         //  word-wide image scans
 #include "MPC_funcs.hpp"
 
 
@@ -228,29 +229,14 @@ void C_AND_BF706xx::DoPowerDown()
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 DWORD C_AND_BF706xx::GetApplicationLength(void)
 {
-  DWORD byteCnt;
-  WORD FFblockSize;
- 
-  FFblockSize = 0;
-  for (byteCnt = 0; byteCnt < m_devparms_p->device_size; byteCnt += 4)
-  {
-    if (GetDataFromRam_32Bit(byteCnt,  (DWORD)m_srcdata_bp) != 0xFFFFFFFF)
-    {
-      FFblockSize = 0;
-    }
-    if (FFblockSize == 128)
-      break;
-    
-    FFblockSize++;  
-  }
+  DWORD runStart;
   
-  if (byteCnt == m_devparms_p->device_size)
-    byteCnt = 0; //end of application did not found - force the programming to fail
-    
-  //adjust byteCnt
-  byteCnt = byteCnt - (FFblockSize * 4) + 4;
+  runStart = MemScan_FindRun((const BYTE*)m_srcdata_bp, m_devparms_p->device_size, 0xFF, 512);
   
-  return byteCnt;
+  if (runStart == m_devparms_p->device_size)
+    return 0; //end of application did not found - force the programming to fail
+    
+  return runStart; //the application ends with the last word before the 0xFF run
 }  
 
 
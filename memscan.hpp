@@ -0,0 +1,71 @@
+//----------------------------------------------------------------------------
+// Name     :   memscan.hpp
+//
+// Purpose  :   word-wide scans of image data (option/marker areas, padding)
+//              The unaligned head and tail of a range are checked byte by byte,
+//              the rest a DWORD at a time.
+//
+// Functions
+// included :   MemScan_FindFirstNot, MemScan_AllEqual, MemScan_FindRun
+//
+//----------------------------------------------------------------------------
+
+#ifndef  MEMSCAN_HPP
+#define  MEMSCAN_HPP
+
+#define MEMSCAN_WORD(value) ((DWORD)(value) * 0x01010101UL)
+
+// Returns the offset of the first byte != value, or length if all bytes are equal to value.
+inline DWORD MemScan_FindFirstNot(const BYTE* data_p, const DWORD length, const BYTE value)
+{
+  const DWORD pattern = MEMSCAN_WORD(value);
+  DWORD offset = 0;
+
+  //head: up to the first DWORD boundary
+  while (offset < length && ((DWORD)(data_p + offset) & 3))
+  {
+    if (data_p[offset] != value)
+      return offset;
+    offset++;
+  }
+  //body: 4 bytes per step
+  while (length - offset >= 4 && *(const DWORD*)(data_p + offset) == pattern)
+    offset += 4;
+  //tail, or the word which contains the mismatch
+  while (offset < length && data_p[offset] == value)
+    offset++;
+
+  return offset;
+}
+
+// Returns true, if all bytes are equal to value.
+inline bool MemScan_AllEqual(const BYTE* data_p, const DWORD length, const BYTE value)
+{
+  return (MemScan_FindFirstNot(data_p, length, value) == length);
+}
+
+// Returns the offset of the first run of at least runLength bytes equal to value, which starts at a DWORD boundary
+// of data_p (data_p has to be DWORD aligned), or length if there is no such run.
+inline DWORD MemScan_FindRun(const BYTE* data_p, const DWORD length, const BYTE value, const DWORD runLength)
+{
+  const DWORD pattern = MEMSCAN_WORD(value);
+  DWORD runStart = 0;
+  DWORD offset = 0;
+
+  while (length - offset >= 4)
+  {
+    if (*(const DWORD*)(data_p + offset) != pattern)
+    {
+      offset += 4;
+      runStart = offset;
+      continue;
+    }
+    offset += 4;
+    if (offset - runStart >= runLength)
+      return runStart;
+  }
+
+  return length;
+}
+
+#endif // MEMSCAN_HPP
@@ -78,6 +78,34 @@
             6.2   : 02/10/21 - Modified Read Function, to enable reading of  Data flash using Exteneded Read Cmd for the Supported devices.
             6.3 	: 02/10/21 -  IDCode from SF Menu will be used to unlock the Device. And the ID in RPI will be Programmed.   
             7.0   : 03/02/21 - Reprogramming and validation of ICUS Flow has been Changed.
+            7.1   : 10/18/26 - SendFrame() builds the complete frame (BuildFrame) and shifts it out in one SerialWrite call.
+            7.2   : 10/18/26 - Sequencer speedup used for all data frames (any length, command and frame end), see LoadSequencer().
+            7.3   : 10/18/26 - GetDataFrame (VERIFY mode) and VerifyDFblock compare the complete frame at once (CompareFrame).
+            7.4   : 10/18/26 - Two sequencer regions: the next page is staged (PreloadFrame) while the device programs the current one.
+            7.5   : 10/18/26 - Job level cache for page checksums (DataSum) and block CRC32 (GetSectorCRC).
+            7.6   : 10/18/26 - CRC32 slice-by-8 with constant tables, combine_crc(); gen_crc_table() removed.
+            7.7   : 10/18/26 - WaitUntilDeviceReady() with ms deadlines and poll backoff, used by all frame functions; wait time histograms.
+            7.8   : 10/18/26 - Optional special feature "Startup - FPGA shift clock": startup frames as bulk shifts at STARTUP_SCI_FREQUENCY.
+            7.9   : 10/18/26 - ReceiveFrame(): one transfer per frame, used by ReadDataFrame, GetDataFrame (READ mode) and Read().
+            7.10  : 10/18/26 - Read(): data received directly into the image (ReceiveFrameToImage), markers set per contiguous range.
+            7.11  : 10/18/26 - CF/DF extent lists built from the MARKER areas (BuildExtents); area checks by binary search.
+            7.12  : 10/18/26 - fragmented CF: one PROGRAM/READ command per extent with chained data frames (ProgramRange, VerifyArea).
+            7.13  : 10/18/26 - option area probes use the word-wide scans of memscan.hpp.
+            7.14  : 10/18/26 - optional feature "Code Flash - skip 0xFF pages": fill-up mode does not program 0xFF units of erased blocks.
+            7.15  : 10/18/26 - Verify mode bit 2: HYBRID_VERIFY - CRC per block, failing blocks are verified page by page to log the failing addresses.
+            7.16  : 10/18/26 - optional feature "Incremental programming": CF blocks with matching CRC on all sockets are not erased and programmed.
+            7.17  : 10/18/26 - optional feature "Erase - range command": contiguous blocks are erased with one ERASE command, fallback block by block.
+            7.18  : 10/18/26 - sockets with different ICU-S status: data flash handled in gang mode per status instead of socket by socket.
+                             - bugfix: all sockets get all data flash blocks (block counter was not reset per socket); ICU-S status update in Erase().
+            7.19  : 10/18/26 - DeviceInit()/IDCheck(): device type and signature compared in gang mode, only failing sockets are read back.
+            7.20  : 10/18/26 - ResetToProgrammingMode(): mode entry delay cached per device type in a file, tried first, demoted if it fails.
+            7.21  : 10/18/26 - optional feature "Power - settle detection": power good/down waits end when the rails are stable.
+            7.22  : 10/18/26 - programming mode session kept over all operations: BeginOperation(), error recovery by gang INQUIRY
+                               instead of reset (RecoverSession()), session statistics logged at power down.
+            7.23  : 10/18/26 - BlankCheck(): contiguous selected blocks checked with one BLANKCHECK command, split block by block on failure.
+            7.24  : 10/18/26 - optional feature "Read - compare all sockets": the read image is compared with all sockets in gang mode.
+            7.25  : 10/18/26 - data flash extents in write units: Program_DataFlash_Area() with one PROGRAM command per extent
+                               (ETB chained frames), Verify_DataFlash_Area() reads the same extents only.
 ***************************************************************************/
 #define ALG_DEBUG 2 // 1-per function, 2-per block, 3 add block info
 
@@ -98,7 +126,8 @@
 
 #include "JTAG_Boost_API.hpp"
 #include "StdWiggler.hpp"
-#include "rtcrv40f.hpp" // class definition for C_RV40F
+#include "rtcrv40f.hpp"  // class definition for C_RV40F
+#include "memscan.hpp"   // word-wide image scans
 #include "MPC_funcs.hpp"
 
 static const char *const __file = __FILE__;
@@ -139,9 +168,8 @@ DWORD SwapEndian(DWORD val)
 //
 // Synopsis:
 //
-// gen_crc_table() -- generates a 256-word table containing all CRC
-//                    remainders for every possible 8-bit byte. It
-//                    must be executed (once) before any CRC updates.
+// crc32_table      -- 8 x 256-word tables (slice-by-8), the first one
+//                    contains the CRC remainders for every possible 8-bit byte.
 //
 // unsigned update_crc(crc_accum, data_blk_ptr, data_blk_size)
 //
@@ -150,6 +178,10 @@ DWORD SwapEndian(DWORD val)
 // Returns the updated value of the CRC accumulator after
 // processing each byte in the addressed block of data.
 //
+// unsigned combine_crc(crc1, crc2, len2)
+//
+// Returns the CRC of two consecutive blocks from the CRCs of the blocks.
+//
 // It is assumed that an unsigned long is at least 32 bits wide and
 // that the predefined type char occupies one 8-bit byte of storage.
 //
@@ -172,11 +204,355 @@ DWORD SwapEndian(DWORD val)
 // by Avram Perez, Byte-wise CRC Calculations, IEEE Micro 3, 40 (1983).
 
 #define POLYNOMIAL 0x04c11db7L
+#define CRC32_INIT 0xFFFFFFFFL
+
+// Slice-by-8 tables, generated offline (no set-up at run time):
+// crc32_table[0][b] = CRC remainder of the byte b (the table of the former gen_crc_table()),
+// crc32_table[k][b] = (crc32_table[k-1][b] << 8) ^ crc32_table[0][crc32_table[k-1][b] >> 24]
+static const DWORD crc32_table[8][256] = {
+  {
+    0x00000000, 0x04C11DB7, 0x09823B6E, 0x0D4326D9, 0x130476DC, 0x17C56B6B, 0x1A864DB2, 0x1E475005,
+    0x2608EDB8, 0x22C9F00F, 0x2F8AD6D6, 0x2B4BCB61, 0x350C9B64, 0x31CD86D3, 0x3C8EA00A, 0x384FBDBD,
+    0x4C11DB70, 0x48D0C6C7, 0x4593E01E, 0x4152FDA9, 0x5F15ADAC, 0x5BD4B01B, 0x569796C2, 0x52568B75,
+    0x6A1936C8, 0x6ED82B7F, 0x639B0DA6, 0x675A1011, 0x791D4014, 0x7DDC5DA3, 0x709F7B7A, 0x745E66CD,
+    0x9823B6E0, 0x9CE2AB57, 0x91A18D8E, 0x95609039, 0x8B27C03C, 0x8FE6DD8B, 0x82A5FB52, 0x8664E6E5,
+    0xBE2B5B58, 0xBAEA46EF, 0xB7A96036, 0xB3687D81, 0xAD2F2D84, 0xA9EE3033, 0xA4AD16EA, 0xA06C0B5D,
+    0xD4326D90, 0xD0F37027, 0xDDB056FE, 0xD9714B49, 0xC7361B4C, 0xC3F706FB, 0xCEB42022, 0xCA753D95,
+    0xF23A8028, 0xF6FB9D9F, 0xFBB8BB46, 0xFF79A6F1, 0xE13EF6F4, 0xE5FFEB43, 0xE8BCCD9A, 0xEC7DD02D,
+    0x34867077, 0x30476DC0, 0x3D044B19, 0x39C556AE, 0x278206AB, 0x23431B1C, 0x2E003DC5, 0x2AC12072,
+    0x128E9DCF, 0x164F8078, 0x1B0CA6A1, 0x1FCDBB16, 0x018AEB13, 0x054BF6A4, 0x0808D07D, 0x0CC9CDCA,
+    0x7897AB07, 0x7C56B6B0, 0x71159069, 0x75D48DDE, 0x6B93DDDB, 0x6F52C06C, 0x6211E6B5, 0x66D0FB02,
+    0x5E9F46BF, 0x5A5E5B08, 0x571D7DD1, 0x53DC6066, 0x4D9B3063, 0x495A2DD4, 0x44190B0D, 0x40D816BA,
+    0xACA5C697, 0xA864DB20, 0xA527FDF9, 0xA1E6E04E, 0xBFA1B04B, 0xBB60ADFC, 0xB6238B25, 0xB2E29692,
+    0x8AAD2B2F, 0x8E6C3698, 0x832F1041, 0x87EE0DF6, 0x99A95DF3, 0x9D684044, 0x902B669D, 0x94EA7B2A,
+    0xE0B41DE7, 0xE4750050, 0xE9362689, 0xEDF73B3E, 0xF3B06B3B, 0xF771768C, 0xFA325055, 0xFEF34DE2,
+    0xC6BCF05F, 0xC27DEDE8, 0xCF3ECB31, 0xCBFFD686, 0xD5B88683, 0xD1799B34, 0xDC3ABDED, 0xD8FBA05A,
+    0x690CE0EE, 0x6DCDFD59, 0x608EDB80, 0x644FC637, 0x7A089632, 0x7EC98B85, 0x738AAD5C, 0x774BB0EB,
+    0x4F040D56, 0x4BC510E1, 0x46863638, 0x42472B8F, 0x5C007B8A, 0x58C1663D, 0x558240E4, 0x51435D53,
+    0x251D3B9E, 0x21DC2629, 0x2C9F00F0, 0x285E1D47, 0x36194D42, 0x32D850F5, 0x3F9B762C, 0x3B5A6B9B,
+    0x0315D626, 0x07D4CB91, 0x0A97ED48, 0x0E56F0FF, 0x1011A0FA, 0x14D0BD4D, 0x19939B94, 0x1D528623,
+    0xF12F560E, 0xF5EE4BB9, 0xF8AD6D60, 0xFC6C70D7, 0xE22B20D2, 0xE6EA3D65, 0xEBA91BBC, 0xEF68060B,
+    0xD727BBB6, 0xD3E6A601, 0xDEA580D8, 0xDA649D6F, 0xC423CD6A, 0xC0E2D0DD, 0xCDA1F604, 0xC960EBB3,
+    0xBD3E8D7E, 0xB9FF90C9, 0xB4BCB610, 0xB07DABA7, 0xAE3AFBA2, 0xAAFBE615, 0xA7B8C0CC, 0xA379DD7B,
+    0x9B3660C6, 0x9FF77D71, 0x92B45BA8, 0x9675461F, 0x8832161A, 0x8CF30BAD, 0x81B02D74, 0x857130C3,
+    0x5D8A9099, 0x594B8D2E, 0x5408ABF7, 0x50C9B640, 0x4E8EE645, 0x4A4FFBF2, 0x470CDD2B, 0x43CDC09C,
+    0x7B827D21, 0x7F436096, 0x7200464F, 0x76C15BF8, 0x68860BFD, 0x6C47164A, 0x61043093, 0x65C52D24,
+    0x119B4BE9, 0x155A565E, 0x18197087, 0x1CD86D30, 0x029F3D35, 0x065E2082, 0x0B1D065B, 0x0FDC1BEC,
+    0x3793A651, 0x3352BBE6, 0x3E119D3F, 0x3AD08088, 0x2497D08D, 0x2056CD3A, 0x2D15EBE3, 0x29D4F654,
+    0xC5A92679, 0xC1683BCE, 0xCC2B1D17, 0xC8EA00A0, 0xD6AD50A5, 0xD26C4D12, 0xDF2F6BCB, 0xDBEE767C,
+    0xE3A1CBC1, 0xE760D676, 0xEA23F0AF, 0xEEE2ED18, 0xF0A5BD1D, 0xF464A0AA, 0xF9278673, 0xFDE69BC4,
+    0x89B8FD09, 0x8D79E0BE, 0x803AC667, 0x84FBDBD0, 0x9ABC8BD5, 0x9E7D9662, 0x933EB0BB, 0x97FFAD0C,
+    0xAFB010B1, 0xAB710D06, 0xA6322BDF, 0xA2F33668, 0xBCB4666D, 0xB8757BDA, 0xB5365D03, 0xB1F740B4
+  },
+  {
+    0x00000000, 0xD219C1DC, 0xA0F29E0F, 0x72EB5FD3, 0x452421A9, 0x973DE075, 0xE5D6BFA6, 0x37CF7E7A,
+    0x8A484352, 0x5851828E, 0x2ABADD5D, 0xF8A31C81, 0xCF6C62FB, 0x1D75A327, 0x6F9EFCF4, 0xBD873D28,
+    0x10519B13, 0xC2485ACF, 0xB0A3051C, 0x62BAC4C0, 0x5575BABA, 0x876C7B66, 0xF58724B5, 0x279EE569,
+    0x9A19D841, 0x4800199D, 0x3AEB464E, 0xE8F28792, 0xDF3DF9E8, 0x0D243834, 0x7FCF67E7, 0xADD6A63B,
+    0x20A33626, 0xF2BAF7FA, 0x8051A829, 0x524869F5, 0x6587178F, 0xB79ED653, 0xC5758980, 0x176C485C,
+    0xAAEB7574, 0x78F2B4A8, 0x0A19EB7B, 0xD8002AA7, 0xEFCF54DD, 0x3DD69501, 0x4F3DCAD2, 0x9D240B0E,
+    0x30F2AD35, 0xE2EB6CE9, 0x9000333A, 0x4219F2E6, 0x75D68C9C, 0xA7CF4D40, 0xD5241293, 0x073DD34F,
+    0xBABAEE67, 0x68A32FBB, 0x1A487068, 0xC851B1B4, 0xFF9ECFCE, 0x2D870E12, 0x5F6C51C1, 0x8D75901D,
+    0x41466C4C, 0x935FAD90, 0xE1B4F243, 0x33AD339F, 0x04624DE5, 0xD67B8C39, 0xA490D3EA, 0x76891236,
+    0xCB0E2F1E, 0x1917EEC2, 0x6BFCB111, 0xB9E570CD, 0x8E2A0EB7, 0x5C33CF6B, 0x2ED890B8, 0xFCC15164,
+    0x5117F75F, 0x830E3683, 0xF1E56950, 0x23FCA88C, 0x1433D6F6, 0xC62A172A, 0xB4C148F9, 0x66D88925,
+    0xDB5FB40D, 0x094675D1, 0x7BAD2A02, 0xA9B4EBDE, 0x9E7B95A4, 0x4C625478, 0x3E890BAB, 0xEC90CA77,
+    0x61E55A6A, 0xB3FC9BB6, 0xC117C465, 0x130E05B9, 0x24C17BC3, 0xF6D8BA1F, 0x8433E5CC, 0x562A2410,
+    0xEBAD1938, 0x39B4D8E4, 0x4B5F8737, 0x994646EB, 0xAE893891, 0x7C90F94D, 0x0E7BA69E, 0xDC626742,
+    0x71B4C179, 0xA3AD00A5, 0xD1465F76, 0x035F9EAA, 0x3490E0D0, 0xE689210C, 0x94627EDF, 0x467BBF03,
+    0xFBFC822B, 0x29E543F7, 0x5B0E1C24, 0x8917DDF8, 0xBED8A382, 0x6CC1625E, 0x1E2A3D8D, 0xCC33FC51,
+    0x828CD898, 0x50951944, 0x227E4697, 0xF067874B, 0xC7A8F931, 0x15B138ED, 0x675A673E, 0xB543A6E2,
+    0x08C49BCA, 0xDADD5A16, 0xA83605C5, 0x7A2FC419, 0x4DE0BA63, 0x9FF97BBF, 0xED12246C, 0x3F0BE5B0,
+    0x92DD438B, 0x40C48257, 0x322FDD84, 0xE0361C58, 0xD7F96222, 0x05E0A3FE, 0x770BFC2D, 0xA5123DF1,
+    0x189500D9, 0xCA8CC105, 0xB8679ED6, 0x6A7E5F0A, 0x5DB12170, 0x8FA8E0AC, 0xFD43BF7F, 0x2F5A7EA3,
+    0xA22FEEBE, 0x70362F62, 0x02DD70B1, 0xD0C4B16D, 0xE70BCF17, 0x35120ECB, 0x47F95118, 0x95E090C4,
+    0x2867ADEC, 0xFA7E6C30, 0x889533E3, 0x5A8CF23F, 0x6D438C45, 0xBF5A4D99, 0xCDB1124A, 0x1FA8D396,
+    0xB27E75AD, 0x6067B471, 0x128CEBA2, 0xC0952A7E, 0xF75A5404, 0x254395D8, 0x57A8CA0B, 0x85B10BD7,
+    0x383636FF, 0xEA2FF723, 0x98C4A8F0, 0x4ADD692C, 0x7D121756, 0xAF0BD68A, 0xDDE08959, 0x0FF94885,
+    0xC3CAB4D4, 0x11D37508, 0x63382ADB, 0xB121EB07, 0x86EE957D, 0x54F754A1, 0x261C0B72, 0xF405CAAE,
+    0x4982F786, 0x9B9B365A, 0xE9706989, 0x3B69A855, 0x0CA6D62F, 0xDEBF17F3, 0xAC544820, 0x7E4D89FC,
+    0xD39B2FC7, 0x0182EE1B, 0x7369B1C8, 0xA1707014, 0x96BF0E6E, 0x44A6CFB2, 0x364D9061, 0xE45451BD,
+    0x59D36C95, 0x8BCAAD49, 0xF921F29A, 0x2B383346, 0x1CF74D3C, 0xCEEE8CE0, 0xBC05D333, 0x6E1C12EF,
+    0xE36982F2, 0x3170432E, 0x439B1CFD, 0x9182DD21, 0xA64DA35B, 0x74546287, 0x06BF3D54, 0xD4A6FC88,
+    0x6921C1A0, 0xBB38007C, 0xC9D35FAF, 0x1BCA9E73, 0x2C05E009, 0xFE1C21D5, 0x8CF77E06, 0x5EEEBFDA,
+    0xF33819E1, 0x2121D83D, 0x53CA87EE, 0x81D34632, 0xB61C3848, 0x6405F994, 0x16EEA647, 0xC4F7679B,
+    0x79705AB3, 0xAB699B6F, 0xD982C4BC, 0x0B9B0560, 0x3C547B1A, 0xEE4DBAC6, 0x9CA6E515, 0x4EBF24C9
+  },
+  {
+    0x00000000, 0x01D8AC87, 0x03B1590E, 0x0269F589, 0x0762B21C, 0x06BA1E9B, 0x04D3EB12, 0x050B4795,
+    0x0EC56438, 0x0F1DC8BF, 0x0D743D36, 0x0CAC91B1, 0x09A7D624, 0x087F7AA3, 0x0A168F2A, 0x0BCE23AD,
+    0x1D8AC870, 0x1C5264F7, 0x1E3B917E, 0x1FE33DF9, 0x1AE87A6C, 0x1B30D6EB, 0x19592362, 0x18818FE5,
+    0x134FAC48, 0x129700CF, 0x10FEF546, 0x112659C1, 0x142D1E54, 0x15F5B2D3, 0x179C475A, 0x1644EBDD,
+    0x3B1590E0, 0x3ACD3C67, 0x38A4C9EE, 0x397C6569, 0x3C7722FC, 0x3DAF8E7B, 0x3FC67BF2, 0x3E1ED775,
+    0x35D0F4D8, 0x3408585F, 0x3661ADD6, 0x37B90151, 0x32B246C4, 0x336AEA43, 0x31031FCA, 0x30DBB34D,
+    0x269F5890, 0x2747F417, 0x252E019E, 0x24F6AD19, 0x21FDEA8C, 0x2025460B, 0x224CB382, 0x23941F05,
+    0x285A3CA8, 0x2982902F, 0x2BEB65A6, 0x2A33C921, 0x2F388EB4, 0x2EE02233, 0x2C89D7BA, 0x2D517B3D,
+    0x762B21C0, 0x77F38D47, 0x759A78CE, 0x7442D449, 0x714993DC, 0x70913F5B, 0x72F8CAD2, 0x73206655,
+    0x78EE45F8, 0x7936E97F, 0x7B5F1CF6, 0x7A87B071, 0x7F8CF7E4, 0x7E545B63, 0x7C3DAEEA, 0x7DE5026D,
+    0x6BA1E9B0, 0x6A794537, 0x6810B0BE, 0x69C81C39, 0x6CC35BAC, 0x6D1BF72B, 0x6F7202A2, 0x6EAAAE25,
+    0x65648D88, 0x64BC210F, 0x66D5D486, 0x670D7801, 0x62063F94, 0x63DE9313, 0x61B7669A, 0x606FCA1D,
+    0x4D3EB120, 0x4CE61DA7, 0x4E8FE82E, 0x4F5744A9, 0x4A5C033C, 0x4B84AFBB, 0x49ED5A32, 0x4835F6B5,
+    0x43FBD518, 0x4223799F, 0x404A8C16, 0x41922091, 0x44996704, 0x4541CB83, 0x47283E0A, 0x46F0928D,
+    0x50B47950, 0x516CD5D7, 0x5305205E, 0x52DD8CD9, 0x57D6CB4C, 0x560E67CB, 0x54679242, 0x55BF3EC5,
+    0x5E711D68, 0x5FA9B1EF, 0x5DC04466, 0x5C18E8E1, 0x5913AF74, 0x58CB03F3, 0x5AA2F67A, 0x5B7A5AFD,
+    0xEC564380, 0xED8EEF07, 0xEFE71A8E, 0xEE3FB609, 0xEB34F19C, 0xEAEC5D1B, 0xE885A892, 0xE95D0415,
+    0xE29327B8, 0xE34B8B3F, 0xE1227EB6, 0xE0FAD231, 0xE5F195A4, 0xE4293923, 0xE640CCAA, 0xE798602D,
+    0xF1DC8BF0, 0xF0042777, 0xF26DD2FE, 0xF3B57E79, 0xF6BE39EC, 0xF766956B, 0xF50F60E2, 0xF4D7CC65,
+    0xFF19EFC8, 0xFEC1434F, 0xFCA8B6C6, 0xFD701A41, 0xF87B5DD4, 0xF9A3F153, 0xFBCA04DA, 0xFA12A85D,
+    0xD743D360, 0xD69B7FE7, 0xD4F28A6E, 0xD52A26E9, 0xD021617C, 0xD1F9CDFB, 0xD3903872, 0xD24894F5,
+    0xD986B758, 0xD85E1BDF, 0xDA37EE56, 0xDBEF42D1, 0xDEE40544, 0xDF3CA9C3, 0xDD555C4A, 0xDC8DF0CD,
+    0xCAC91B10, 0xCB11B797, 0xC978421E, 0xC8A0EE99, 0xCDABA90C, 0xCC73058B, 0xCE1AF002, 0xCFC25C85,
+    0xC40C7F28, 0xC5D4D3AF, 0xC7BD2626, 0xC6658AA1, 0xC36ECD34, 0xC2B661B3, 0xC0DF943A, 0xC10738BD,
+    0x9A7D6240, 0x9BA5CEC7, 0x99CC3B4E, 0x981497C9, 0x9D1FD05C, 0x9CC77CDB, 0x9EAE8952, 0x9F7625D5,
+    0x94B80678, 0x9560AAFF, 0x97095F76, 0x96D1F3F1, 0x93DAB464, 0x920218E3, 0x906BED6A, 0x91B341ED,
+    0x87F7AA30, 0x862F06B7, 0x8446F33E, 0x859E5FB9, 0x8095182C, 0x814DB4AB, 0x83244122, 0x82FCEDA5,
+    0x8932CE08, 0x88EA628F, 0x8A839706, 0x8B5B3B81, 0x8E507C14, 0x8F88D093, 0x8DE1251A, 0x8C39899D,
+    0xA168F2A0, 0xA0B05E27, 0xA2D9ABAE, 0xA3010729, 0xA60A40BC, 0xA7D2EC3B, 0xA5BB19B2, 0xA463B535,
+    0xAFAD9698, 0xAE753A1F, 0xAC1CCF96, 0xADC46311, 0xA8CF2484, 0xA9178803, 0xAB7E7D8A, 0xAAA6D10D,
+    0xBCE23AD0, 0xBD3A9657, 0xBF5363DE, 0xBE8BCF59, 0xBB8088CC, 0xBA58244B, 0xB831D1C2, 0xB9E97D45,
+    0xB2275EE8, 0xB3FFF26F, 0xB19607E6, 0xB04EAB61, 0xB545ECF4, 0xB49D4073, 0xB6F4B5FA, 0xB72C197D
+  },
+  {
+    0x00000000, 0xDC6D9AB7, 0xBC1A28D9, 0x6077B26E, 0x7CF54C05, 0xA098D6B2, 0xC0EF64DC, 0x1C82FE6B,
+    0xF9EA980A, 0x258702BD, 0x45F0B0D3, 0x999D2A64, 0x851FD40F, 0x59724EB8, 0x3905FCD6, 0xE5686661,
+    0xF7142DA3, 0x2B79B714, 0x4B0E057A, 0x97639FCD, 0x8BE161A6, 0x578CFB11, 0x37FB497F, 0xEB96D3C8,
+    0x0EFEB5A9, 0xD2932F1E, 0xB2E49D70, 0x6E8907C7, 0x720BF9AC, 0xAE66631B, 0xCE11D175, 0x127C4BC2,
+    0xEAE946F1, 0x3684DC46, 0x56F36E28, 0x8A9EF49F, 0x961C0AF4, 0x4A719043, 0x2A06222D, 0xF66BB89A,
+    0x1303DEFB, 0xCF6E444C, 0xAF19F622, 0x73746C95, 0x6FF692FE, 0xB39B0849, 0xD3ECBA27, 0x0F812090,
+    0x1DFD6B52, 0xC190F1E5, 0xA1E7438B, 0x7D8AD93C, 0x61082757, 0xBD65BDE0, 0xDD120F8E, 0x017F9539,
+    0xE417F358, 0x387A69EF, 0x580DDB81, 0x84604136, 0x98E2BF5D, 0x448F25EA, 0x24F89784, 0xF8950D33,
+    0xD1139055, 0x0D7E0AE2, 0x6D09B88C, 0xB164223B, 0xADE6DC50, 0x718B46E7, 0x11FCF489, 0xCD916E3E,
+    0x28F9085F, 0xF49492E8, 0x94E32086, 0x488EBA31, 0x540C445A, 0x8861DEED, 0xE8166C83, 0x347BF634,
+    0x2607BDF6, 0xFA6A2741, 0x9A1D952F, 0x46700F98, 0x5AF2F1F3, 0x869F6B44, 0xE6E8D92A, 0x3A85439D,
+    0xDFED25FC, 0x0380BF4B, 0x63F70D25, 0xBF9A9792, 0xA31869F9, 0x7F75F34E, 0x1F024120, 0xC36FDB97,
+    0x3BFAD6A4, 0xE7974C13, 0x87E0FE7D, 0x5B8D64CA, 0x470F9AA1, 0x9B620016, 0xFB15B278, 0x277828CF,
+    0xC2104EAE, 0x1E7DD419, 0x7E0A6677, 0xA267FCC0, 0xBEE502AB, 0x6288981C, 0x02FF2A72, 0xDE92B0C5,
+    0xCCEEFB07, 0x108361B0, 0x70F4D3DE, 0xAC994969, 0xB01BB702, 0x6C762DB5, 0x0C019FDB, 0xD06C056C,
+    0x3504630D, 0xE969F9BA, 0x891E4BD4, 0x5573D163, 0x49F12F08, 0x959CB5BF, 0xF5EB07D1, 0x29869D66,
+    0xA6E63D1D, 0x7A8BA7AA, 0x1AFC15C4, 0xC6918F73, 0xDA137118, 0x067EEBAF, 0x660959C1, 0xBA64C376,
+    0x5F0CA517, 0x83613FA0, 0xE3168DCE, 0x3F7B1779, 0x23F9E912, 0xFF9473A5, 0x9FE3C1CB, 0x438E5B7C,
+    0x51F210BE, 0x8D9F8A09, 0xEDE83867, 0x3185A2D0, 0x2D075CBB, 0xF16AC60C, 0x911D7462, 0x4D70EED5,
+    0xA81888B4, 0x74751203, 0x1402A06D, 0xC86F3ADA, 0xD4EDC4B1, 0x08805E06, 0x68F7EC68, 0xB49A76DF,
+    0x4C0F7BEC, 0x9062E15B, 0xF0155335, 0x2C78C982, 0x30FA37E9, 0xEC97AD5E, 0x8CE01F30, 0x508D8587,
+    0xB5E5E3E6, 0x69887951, 0x09FFCB3F, 0xD5925188, 0xC910AFE3, 0x157D3554, 0x750A873A, 0xA9671D8D,
+    0xBB1B564F, 0x6776CCF8, 0x07017E96, 0xDB6CE421, 0xC7EE1A4A, 0x1B8380FD, 0x7BF43293, 0xA799A824,
+    0x42F1CE45, 0x9E9C54F2, 0xFEEBE69C, 0x22867C2B, 0x3E048240, 0xE26918F7, 0x821EAA99, 0x5E73302E,
+    0x77F5AD48, 0xAB9837FF, 0xCBEF8591, 0x17821F26, 0x0B00E14D, 0xD76D7BFA, 0xB71AC994, 0x6B775323,
+    0x8E1F3542, 0x5272AFF5, 0x32051D9B, 0xEE68872C, 0xF2EA7947, 0x2E87E3F0, 0x4EF0519E, 0x929DCB29,
+    0x80E180EB, 0x5C8C1A5C, 0x3CFBA832, 0xE0963285, 0xFC14CCEE, 0x20795659, 0x400EE437, 0x9C637E80,
+    0x790B18E1, 0xA5668256, 0xC5113038, 0x197CAA8F, 0x05FE54E4, 0xD993CE53, 0xB9E47C3D, 0x6589E68A,
+    0x9D1CEBB9, 0x4171710E, 0x2106C360, 0xFD6B59D7, 0xE1E9A7BC, 0x3D843D0B, 0x5DF38F65, 0x819E15D2,
+    0x64F673B3, 0xB89BE904, 0xD8EC5B6A, 0x0481C1DD, 0x18033FB6, 0xC46EA501, 0xA419176F, 0x78748DD8,
+    0x6A08C61A, 0xB6655CAD, 0xD612EEC3, 0x0A7F7474, 0x16FD8A1F, 0xCA9010A8, 0xAAE7A2C6, 0x768A3871,
+    0x93E25E10, 0x4F8FC4A7, 0x2FF876C9, 0xF395EC7E, 0xEF171215, 0x337A88A2, 0x530D3ACC, 0x8F60A07B
+  },
+  {
+    0x00000000, 0x490D678D, 0x921ACF1A, 0xDB17A897, 0x20F48383, 0x69F9E40E, 0xB2EE4C99, 0xFBE32B14,
+    0x41E90706, 0x08E4608B, 0xD3F3C81C, 0x9AFEAF91, 0x611D8485, 0x2810E308, 0xF3074B9F, 0xBA0A2C12,
+    0x83D20E0C, 0xCADF6981, 0x11C8C116, 0x58C5A69B, 0xA3268D8F, 0xEA2BEA02, 0x313C4295, 0x78312518,
+    0xC23B090A, 0x8B366E87, 0x5021C610, 0x192CA19D, 0xE2CF8A89, 0xABC2ED04, 0x70D54593, 0x39D8221E,
+    0x036501AF, 0x4A686622, 0x917FCEB5, 0xD872A938, 0x2391822C, 0x6A9CE5A1, 0xB18B4D36, 0xF8862ABB,
+    0x428C06A9, 0x0B816124, 0xD096C9B3, 0x999BAE3E, 0x6278852A, 0x2B75E2A7, 0xF0624A30, 0xB96F2DBD,
+    0x80B70FA3, 0xC9BA682E, 0x12ADC0B9, 0x5BA0A734, 0xA0438C20, 0xE94EEBAD, 0x3259433A, 0x7B5424B7,
+    0xC15E08A5, 0x88536F28, 0x5344C7BF, 0x1A49A032, 0xE1AA8B26, 0xA8A7ECAB, 0x73B0443C, 0x3ABD23B1,
+    0x06CA035E, 0x4FC764D3, 0x94D0CC44, 0xDDDDABC9, 0x263E80DD, 0x6F33E750, 0xB4244FC7, 0xFD29284A,
+    0x47230458, 0x0E2E63D5, 0xD539CB42, 0x9C34ACCF, 0x67D787DB, 0x2EDAE056, 0xF5CD48C1, 0xBCC02F4C,
+    0x85180D52, 0xCC156ADF, 0x1702C248, 0x5E0FA5C5, 0xA5EC8ED1, 0xECE1E95C, 0x37F641CB, 0x7EFB2646,
+    0xC4F10A54, 0x8DFC6DD9, 0x56EBC54E, 0x1FE6A2C3, 0xE40589D7, 0xAD08EE5A, 0x761F46CD, 0x3F122140,
+    0x05AF02F1, 0x4CA2657C, 0x97B5CDEB, 0xDEB8AA66, 0x255B8172, 0x6C56E6FF, 0xB7414E68, 0xFE4C29E5,
+    0x444605F7, 0x0D4B627A, 0xD65CCAED, 0x9F51AD60, 0x64B28674, 0x2DBFE1F9, 0xF6A8496E, 0xBFA52EE3,
+    0x867D0CFD, 0xCF706B70, 0x1467C3E7, 0x5D6AA46A, 0xA6898F7E, 0xEF84E8F3, 0x34934064, 0x7D9E27E9,
+    0xC7940BFB, 0x8E996C76, 0x558EC4E1, 0x1C83A36C, 0xE7608878, 0xAE6DEFF5, 0x757A4762, 0x3C7720EF,
+    0x0D9406BC, 0x44996131, 0x9F8EC9A6, 0xD683AE2B, 0x2D60853F, 0x646DE2B2, 0xBF7A4A25, 0xF6772DA8,
+    0x4C7D01BA, 0x05706637, 0xDE67CEA0, 0x976AA92D, 0x6C898239, 0x2584E5B4, 0xFE934D23, 0xB79E2AAE,
+    0x8E4608B0, 0xC74B6F3D, 0x1C5CC7AA, 0x5551A027, 0xAEB28B33, 0xE7BFECBE, 0x3CA84429, 0x75A523A4,
+    0xCFAF0FB6, 0x86A2683B, 0x5DB5C0AC, 0x14B8A721, 0xEF5B8C35, 0xA656EBB8, 0x7D41432F, 0x344C24A2,
+    0x0EF10713, 0x47FC609E, 0x9CEBC809, 0xD5E6AF84, 0x2E058490, 0x6708E31D, 0xBC1F4B8A, 0xF5122C07,
+    0x4F180015, 0x06156798, 0xDD02CF0F, 0x940FA882, 0x6FEC8396, 0x26E1E41B, 0xFDF64C8C, 0xB4FB2B01,
+    0x8D23091F, 0xC42E6E92, 0x1F39C605, 0x5634A188, 0xADD78A9C, 0xE4DAED11, 0x3FCD4586, 0x76C0220B,
+    0xCCCA0E19, 0x85C76994, 0x5ED0C103, 0x17DDA68E, 0xEC3E8D9A, 0xA533EA17, 0x7E244280, 0x3729250D,
+    0x0B5E05E2, 0x4253626F, 0x9944CAF8, 0xD049AD75, 0x2BAA8661, 0x62A7E1EC, 0xB9B0497B, 0xF0BD2EF6,
+    0x4AB702E4, 0x03BA6569, 0xD8ADCDFE, 0x91A0AA73, 0x6A438167, 0x234EE6EA, 0xF8594E7D, 0xB15429F0,
+    0x888C0BEE, 0xC1816C63, 0x1A96C4F4, 0x539BA379, 0xA878886D, 0xE175EFE0, 0x3A624777, 0x736F20FA,
+    0xC9650CE8, 0x80686B65, 0x5B7FC3F2, 0x1272A47F, 0xE9918F6B, 0xA09CE8E6, 0x7B8B4071, 0x328627FC,
+    0x083B044D, 0x413663C0, 0x9A21CB57, 0xD32CACDA, 0x28CF87CE, 0x61C2E043, 0xBAD548D4, 0xF3D82F59,
+    0x49D2034B, 0x00DF64C6, 0xDBC8CC51, 0x92C5ABDC, 0x692680C8, 0x202BE745, 0xFB3C4FD2, 0xB231285F,
+    0x8BE90A41, 0xC2E46DCC, 0x19F3C55B, 0x50FEA2D6, 0xAB1D89C2, 0xE210EE4F, 0x390746D8, 0x700A2155,
+    0xCA000D47, 0x830D6ACA, 0x581AC25D, 0x1117A5D0, 0xEAF48EC4, 0xA3F9E949, 0x78EE41DE, 0x31E32653
+  },
+  {
+    0x00000000, 0x1B280D78, 0x36501AF0, 0x2D781788, 0x6CA035E0, 0x77883898, 0x5AF02F10, 0x41D82268,
+    0xD9406BC0, 0xC26866B8, 0xEF107130, 0xF4387C48, 0xB5E05E20, 0xAEC85358, 0x83B044D0, 0x989849A8,
+    0xB641CA37, 0xAD69C74F, 0x8011D0C7, 0x9B39DDBF, 0xDAE1FFD7, 0xC1C9F2AF, 0xECB1E527, 0xF799E85F,
+    0x6F01A1F7, 0x7429AC8F, 0x5951BB07, 0x4279B67F, 0x03A19417, 0x1889996F, 0x35F18EE7, 0x2ED9839F,
+    0x684289D9, 0x736A84A1, 0x5E129329, 0x453A9E51, 0x04E2BC39, 0x1FCAB141, 0x32B2A6C9, 0x299AABB1,
+    0xB102E219, 0xAA2AEF61, 0x8752F8E9, 0x9C7AF591, 0xDDA2D7F9, 0xC68ADA81, 0xEBF2CD09, 0xF0DAC071,
+    0xDE0343EE, 0xC52B4E96, 0xE853591E, 0xF37B5466, 0xB2A3760E, 0xA98B7B76, 0x84F36CFE, 0x9FDB6186,
+    0x0743282E, 0x1C6B2556, 0x311332DE, 0x2A3B3FA6, 0x6BE31DCE, 0x70CB10B6, 0x5DB3073E, 0x469B0A46,
+    0xD08513B2, 0xCBAD1ECA, 0xE6D50942, 0xFDFD043A, 0xBC252652, 0xA70D2B2A, 0x8A753CA2, 0x915D31DA,
+    0x09C57872, 0x12ED750A, 0x3F956282, 0x24BD6FFA, 0x65654D92, 0x7E4D40EA, 0x53355762, 0x481D5A1A,
+    0x66C4D985, 0x7DECD4FD, 0x5094C375, 0x4BBCCE0D, 0x0A64EC65, 0x114CE11D, 0x3C34F695, 0x271CFBED,
+    0xBF84B245, 0xA4ACBF3D, 0x89D4A8B5, 0x92FCA5CD, 0xD32487A5, 0xC80C8ADD, 0xE5749D55, 0xFE5C902D,
+    0xB8C79A6B, 0xA3EF9713, 0x8E97809B, 0x95BF8DE3, 0xD467AF8B, 0xCF4FA2F3, 0xE237B57B, 0xF91FB803,
+    0x6187F1AB, 0x7AAFFCD3, 0x57D7EB5B, 0x4CFFE623, 0x0D27C44B, 0x160FC933, 0x3B77DEBB, 0x205FD3C3,
+    0x0E86505C, 0x15AE5D24, 0x38D64AAC, 0x23FE47D4, 0x622665BC, 0x790E68C4, 0x54767F4C, 0x4F5E7234,
+    0xD7C63B9C, 0xCCEE36E4, 0xE196216C, 0xFABE2C14, 0xBB660E7C, 0xA04E0304, 0x8D36148C, 0x961E19F4,
+    0xA5CB3AD3, 0xBEE337AB, 0x939B2023, 0x88B32D5B, 0xC96B0F33, 0xD243024B, 0xFF3B15C3, 0xE41318BB,
+    0x7C8B5113, 0x67A35C6B, 0x4ADB4BE3, 0x51F3469B, 0x102B64F3, 0x0B03698B, 0x267B7E03, 0x3D53737B,
+    0x138AF0E4, 0x08A2FD9C, 0x25DAEA14, 0x3EF2E76C, 0x7F2AC504, 0x6402C87C, 0x497ADFF4, 0x5252D28C,
+    0xCACA9B24, 0xD1E2965C, 0xFC9A81D4, 0xE7B28CAC, 0xA66AAEC4, 0xBD42A3BC, 0x903AB434, 0x8B12B94C,
+    0xCD89B30A, 0xD6A1BE72, 0xFBD9A9FA, 0xE0F1A482, 0xA12986EA, 0xBA018B92, 0x97799C1A, 0x8C519162,
+    0x14C9D8CA, 0x0FE1D5B2, 0x2299C23A, 0x39B1CF42, 0x7869ED2A, 0x6341E052, 0x4E39F7DA, 0x5511FAA2,
+    0x7BC8793D, 0x60E07445, 0x4D9863CD, 0x56B06EB5, 0x17684CDD, 0x0C4041A5, 0x2138562D, 0x3A105B55,
+    0xA28812FD, 0xB9A01F85, 0x94D8080D, 0x8FF00575, 0xCE28271D, 0xD5002A65, 0xF8783DED, 0xE3503095,
+    0x754E2961, 0x6E662419, 0x431E3391, 0x58363EE9, 0x19EE1C81, 0x02C611F9, 0x2FBE0671, 0x34960B09,
+    0xAC0E42A1, 0xB7264FD9, 0x9A5E5851, 0x81765529, 0xC0AE7741, 0xDB867A39, 0xF6FE6DB1, 0xEDD660C9,
+    0xC30FE356, 0xD827EE2E, 0xF55FF9A6, 0xEE77F4DE, 0xAFAFD6B6, 0xB487DBCE, 0x99FFCC46, 0x82D7C13E,
+    0x1A4F8896, 0x016785EE, 0x2C1F9266, 0x37379F1E, 0x76EFBD76, 0x6DC7B00E, 0x40BFA786, 0x5B97AAFE,
+    0x1D0CA0B8, 0x0624ADC0, 0x2B5CBA48, 0x3074B730, 0x71AC9558, 0x6A849820, 0x47FC8FA8, 0x5CD482D0,
+    0xC44CCB78, 0xDF64C600, 0xF21CD188, 0xE934DCF0, 0xA8ECFE98, 0xB3C4F3E0, 0x9EBCE468, 0x8594E910,
+    0xAB4D6A8F, 0xB06567F7, 0x9D1D707F, 0x86357D07, 0xC7ED5F6F, 0xDCC55217, 0xF1BD459F, 0xEA9548E7,
+    0x720D014F, 0x69250C37, 0x445D1BBF, 0x5F7516C7, 0x1EAD34AF, 0x058539D7, 0x28FD2E5F, 0x33D52327
+  },
+  {
+    0x00000000, 0x4F576811, 0x9EAED022, 0xD1F9B833, 0x399CBDF3, 0x76CBD5E2, 0xA7326DD1, 0xE86505C0,
+    0x73397BE6, 0x3C6E13F7, 0xED97ABC4, 0xA2C0C3D5, 0x4AA5C615, 0x05F2AE04, 0xD40B1637, 0x9B5C7E26,
+    0xE672F7CC, 0xA9259FDD, 0x78DC27EE, 0x378B4FFF, 0xDFEE4A3F, 0x90B9222E, 0x41409A1D, 0x0E17F20C,
+    0x954B8C2A, 0xDA1CE43B, 0x0BE55C08, 0x44B23419, 0xACD731D9, 0xE38059C8, 0x3279E1FB, 0x7D2E89EA,
+    0xC824F22F, 0x87739A3E, 0x568A220D, 0x19DD4A1C, 0xF1B84FDC, 0xBEEF27CD, 0x6F169FFE, 0x2041F7EF,
+    0xBB1D89C9, 0xF44AE1D8, 0x25B359EB, 0x6AE431FA, 0x8281343A, 0xCDD65C2B, 0x1C2FE418, 0x53788C09,
+    0x2E5605E3, 0x61016DF2, 0xB0F8D5C1, 0xFFAFBDD0, 0x17CAB810, 0x589DD001, 0x89646832, 0xC6330023,
+    0x5D6F7E05, 0x12381614, 0xC3C1AE27, 0x8C96C636, 0x64F3C3F6, 0x2BA4ABE7, 0xFA5D13D4, 0xB50A7BC5,
+    0x9488F9E9, 0xDBDF91F8, 0x0A2629CB, 0x457141DA, 0xAD14441A, 0xE2432C0B, 0x33BA9438, 0x7CEDFC29,
+    0xE7B1820F, 0xA8E6EA1E, 0x791F522D, 0x36483A3C, 0xDE2D3FFC, 0x917A57ED, 0x4083EFDE, 0x0FD487CF,
+    0x72FA0E25, 0x3DAD6634, 0xEC54DE07, 0xA303B616, 0x4B66B3D6, 0x0431DBC7, 0xD5C863F4, 0x9A9F0BE5,
+    0x01C375C3, 0x4E941DD2, 0x9F6DA5E1, 0xD03ACDF0, 0x385FC830, 0x7708A021, 0xA6F11812, 0xE9A67003,
+    0x5CAC0BC6, 0x13FB63D7, 0xC202DBE4, 0x8D55B3F5, 0x6530B635, 0x2A67DE24, 0xFB9E6617, 0xB4C90E06,
+    0x2F957020, 0x60C21831, 0xB13BA002, 0xFE6CC813, 0x1609CDD3, 0x595EA5C2, 0x88A71DF1, 0xC7F075E0,
+    0xBADEFC0A, 0xF589941B, 0x24702C28, 0x6B274439, 0x834241F9, 0xCC1529E8, 0x1DEC91DB, 0x52BBF9CA,
+    0xC9E787EC, 0x86B0EFFD, 0x574957CE, 0x181E3FDF, 0xF07B3A1F, 0xBF2C520E, 0x6ED5EA3D, 0x2182822C,
+    0x2DD0EE65, 0x62878674, 0xB37E3E47, 0xFC295656, 0x144C5396, 0x5B1B3B87, 0x8AE283B4, 0xC5B5EBA5,
+    0x5EE99583, 0x11BEFD92, 0xC04745A1, 0x8F102DB0, 0x67752870, 0x28224061, 0xF9DBF852, 0xB68C9043,
+    0xCBA219A9, 0x84F571B8, 0x550CC98B, 0x1A5BA19A, 0xF23EA45A, 0xBD69CC4B, 0x6C907478, 0x23C71C69,
+    0xB89B624F, 0xF7CC0A5E, 0x2635B26D, 0x6962DA7C, 0x8107DFBC, 0xCE50B7AD, 0x1FA90F9E, 0x50FE678F,
+    0xE5F41C4A, 0xAAA3745B, 0x7B5ACC68, 0x340DA479, 0xDC68A1B9, 0x933FC9A8, 0x42C6719B, 0x0D91198A,
+    0x96CD67AC, 0xD99A0FBD, 0x0863B78E, 0x4734DF9F, 0xAF51DA5F, 0xE006B24E, 0x31FF0A7D, 0x7EA8626C,
+    0x0386EB86, 0x4CD18397, 0x9D283BA4, 0xD27F53B5, 0x3A1A5675, 0x754D3E64, 0xA4B48657, 0xEBE3EE46,
+    0x70BF9060, 0x3FE8F871, 0xEE114042, 0xA1462853, 0x49232D93, 0x06744582, 0xD78DFDB1, 0x98DA95A0,
+    0xB958178C, 0xF60F7F9D, 0x27F6C7AE, 0x68A1AFBF, 0x80C4AA7F, 0xCF93C26E, 0x1E6A7A5D, 0x513D124C,
+    0xCA616C6A, 0x8536047B, 0x54CFBC48, 0x1B98D459, 0xF3FDD199, 0xBCAAB988, 0x6D5301BB, 0x220469AA,
+    0x5F2AE040, 0x107D8851, 0xC1843062, 0x8ED35873, 0x66B65DB3, 0x29E135A2, 0xF8188D91, 0xB74FE580,
+    0x2C139BA6, 0x6344F3B7, 0xB2BD4B84, 0xFDEA2395, 0x158F2655, 0x5AD84E44, 0x8B21F677, 0xC4769E66,
+    0x717CE5A3, 0x3E2B8DB2, 0xEFD23581, 0xA0855D90, 0x48E05850, 0x07B73041, 0xD64E8872, 0x9919E063,
+    0x02459E45, 0x4D12F654, 0x9CEB4E67, 0xD3BC2676, 0x3BD923B6, 0x748E4BA7, 0xA577F394, 0xEA209B85,
+    0x970E126F, 0xD8597A7E, 0x09A0C24D, 0x46F7AA5C, 0xAE92AF9C, 0xE1C5C78D, 0x303C7FBE, 0x7F6B17AF,
+    0xE4376989, 0xAB600198, 0x7A99B9AB, 0x35CED1BA, 0xDDABD47A, 0x92FCBC6B, 0x43050458, 0x0C526C49
+  },
+  {
+    0x00000000, 0x5BA1DCCA, 0xB743B994, 0xECE2655E, 0x6A466E9F, 0x31E7B255, 0xDD05D70B, 0x86A40BC1,
+    0xD48CDD3E, 0x8F2D01F4, 0x63CF64AA, 0x386EB860, 0xBECAB3A1, 0xE56B6F6B, 0x09890A35, 0x5228D6FF,
+    0xADD8A7CB, 0xF6797B01, 0x1A9B1E5F, 0x413AC295, 0xC79EC954, 0x9C3F159E, 0x70DD70C0, 0x2B7CAC0A,
+    0x79547AF5, 0x22F5A63F, 0xCE17C361, 0x95B61FAB, 0x1312146A, 0x48B3C8A0, 0xA451ADFE, 0xFFF07134,
+    0x5F705221, 0x04D18EEB, 0xE833EBB5, 0xB392377F, 0x35363CBE, 0x6E97E074, 0x8275852A, 0xD9D459E0,
+    0x8BFC8F1F, 0xD05D53D5, 0x3CBF368B, 0x671EEA41, 0xE1BAE180, 0xBA1B3D4A, 0x56F95814, 0x0D5884DE,
+    0xF2A8F5EA, 0xA9092920, 0x45EB4C7E, 0x1E4A90B4, 0x98EE9B75, 0xC34F47BF, 0x2FAD22E1, 0x740CFE2B,
+    0x262428D4, 0x7D85F41E, 0x91679140, 0xCAC64D8A, 0x4C62464B, 0x17C39A81, 0xFB21FFDF, 0xA0802315,
+    0xBEE0A442, 0xE5417888, 0x09A31DD6, 0x5202C11C, 0xD4A6CADD, 0x8F071617, 0x63E57349, 0x3844AF83,
+    0x6A6C797C, 0x31CDA5B6, 0xDD2FC0E8, 0x868E1C22, 0x002A17E3, 0x5B8BCB29, 0xB769AE77, 0xECC872BD,
+    0x13380389, 0x4899DF43, 0xA47BBA1D, 0xFFDA66D7, 0x797E6D16, 0x22DFB1DC, 0xCE3DD482, 0x959C0848,
+    0xC7B4DEB7, 0x9C15027D, 0x70F76723, 0x2B56BBE9, 0xADF2B028, 0xF6536CE2, 0x1AB109BC, 0x4110D576,
+    0xE190F663, 0xBA312AA9, 0x56D34FF7, 0x0D72933D, 0x8BD698FC, 0xD0774436, 0x3C952168, 0x6734FDA2,
+    0x351C2B5D, 0x6EBDF797, 0x825F92C9, 0xD9FE4E03, 0x5F5A45C2, 0x04FB9908, 0xE819FC56, 0xB3B8209C,
+    0x4C4851A8, 0x17E98D62, 0xFB0BE83C, 0xA0AA34F6, 0x260E3F37, 0x7DAFE3FD, 0x914D86A3, 0xCAEC5A69,
+    0x98C48C96, 0xC365505C, 0x2F873502, 0x7426E9C8, 0xF282E209, 0xA9233EC3, 0x45C15B9D, 0x1E608757,
+    0x79005533, 0x22A189F9, 0xCE43ECA7, 0x95E2306D, 0x13463BAC, 0x48E7E766, 0xA4058238, 0xFFA45EF2,
+    0xAD8C880D, 0xF62D54C7, 0x1ACF3199, 0x416EED53, 0xC7CAE692, 0x9C6B3A58, 0x70895F06, 0x2B2883CC,
+    0xD4D8F2F8, 0x8F792E32, 0x639B4B6C, 0x383A97A6, 0xBE9E9C67, 0xE53F40AD, 0x09DD25F3, 0x527CF939,
+    0x00542FC6, 0x5BF5F30C, 0xB7179652, 0xECB64A98, 0x6A124159, 0x31B39D93, 0xDD51F8CD, 0x86F02407,
+    0x26700712, 0x7DD1DBD8, 0x9133BE86, 0xCA92624C, 0x4C36698D, 0x1797B547, 0xFB75D019, 0xA0D40CD3,
+    0xF2FCDA2C, 0xA95D06E6, 0x45BF63B8, 0x1E1EBF72, 0x98BAB4B3, 0xC31B6879, 0x2FF90D27, 0x7458D1ED,
+    0x8BA8A0D9, 0xD0097C13, 0x3CEB194D, 0x674AC587, 0xE1EECE46, 0xBA4F128C, 0x56AD77D2, 0x0D0CAB18,
+    0x5F247DE7, 0x0485A12D, 0xE867C473, 0xB3C618B9, 0x35621378, 0x6EC3CFB2, 0x8221AAEC, 0xD9807626,
+    0xC7E0F171, 0x9C412DBB, 0x70A348E5, 0x2B02942F, 0xADA69FEE, 0xF6074324, 0x1AE5267A, 0x4144FAB0,
+    0x136C2C4F, 0x48CDF085, 0xA42F95DB, 0xFF8E4911, 0x792A42D0, 0x228B9E1A, 0xCE69FB44, 0x95C8278E,
+    0x6A3856BA, 0x31998A70, 0xDD7BEF2E, 0x86DA33E4, 0x007E3825, 0x5BDFE4EF, 0xB73D81B1, 0xEC9C5D7B,
+    0xBEB48B84, 0xE515574E, 0x09F73210, 0x5256EEDA, 0xD4F2E51B, 0x8F5339D1, 0x63B15C8F, 0x38108045,
+    0x9890A350, 0xC3317F9A, 0x2FD31AC4, 0x7472C60E, 0xF2D6CDCF, 0xA9771105, 0x4595745B, 0x1E34A891,
+    0x4C1C7E6E, 0x17BDA2A4, 0xFB5FC7FA, 0xA0FE1B30, 0x265A10F1, 0x7DFBCC3B, 0x9119A965, 0xCAB875AF,
+    0x3548049B, 0x6EE9D851, 0x820BBD0F, 0xD9AA61C5, 0x5F0E6A04, 0x04AFB6CE, 0xE84DD390, 0xB3EC0F5A,
+    0xE1C4D9A5, 0xBA65056F, 0x56876031, 0x0D26BCFB, 0x8B82B73A, 0xD0236BF0, 0x3CC10EAE, 0x6760D264
+  }
+};
+
+// update the CRC on the data block, 8 bytes per step (slice-by-8).
+// The data words are assembled byte by byte, so the result does not depend
+// on the alignment of data_blk_ptr or on the byte order of the host.
+DWORD update_crc(DWORD crc_accum, const BYTE *data_blk_ptr, DWORD data_blk_size)
+{
+  register DWORD j;
+
+  for (j = data_blk_size / 8; j; j--)
+  {
+    crc_accum ^= ((DWORD)data_blk_ptr[0] << 24) | ((DWORD)data_blk_ptr[1] << 16) |
+                 ((DWORD)data_blk_ptr[2] << 8) | (DWORD)data_blk_ptr[3];
+    crc_accum = crc32_table[7][crc_accum >> 24] ^ crc32_table[6][(crc_accum >> 16) & 0xff] ^
+                crc32_table[5][(crc_accum >> 8) & 0xff] ^ crc32_table[4][crc_accum & 0xff] ^
+                crc32_table[3][data_blk_ptr[4]] ^ crc32_table[2][data_blk_ptr[5]] ^
+                crc32_table[1][data_blk_ptr[6]] ^ crc32_table[0][data_blk_ptr[7]];
+    data_blk_ptr += 8;
+  }
+  for (j = data_blk_size % 8; j; j--)
+    crc_accum = (crc_accum << 8) ^ crc32_table[0][((crc_accum >> 24) ^ *data_blk_ptr++) & 0xff];
+
+  return crc_accum;
+}
+
+// a * b modulo POLYNOMIAL (bit 31 = coefficient of x^31)
+static DWORD crc_multmodp(DWORD a, DWORD b)
+{
+  DWORD prod = 0;
+  DWORD m;
+
+  for (m = 0x80000000L; m; m >>= 1)
+  {
+    if (prod & 0x80000000L)
+      prod = (prod << 1) ^ POLYNOMIAL;
+    else
+      prod = (prod << 1);
+    if (a & m)
+      prod ^= b;
+  }
+  return prod;
+}
+
+// x^(8 * n) modulo POLYNOMIAL: shifts a CRC over n zero bytes
+static DWORD crc_x8nmodp(DWORD n)
+{
+  DWORD xp = 0x00000001L; // x^0
+  DWORD sq = 0x00000100L; // x^8
+
+  while (n)
+  {
+    if (n & 1)
+      xp = crc_multmodp(xp, sq);
+    sq = crc_multmodp(sq, sq);
+    n >>= 1;
+  }
+  return xp;
+}
+
+// combine the CRCs of two consecutive data blocks, both calculated with CRC32_INIT:
+// crc1 = CRC of block 1, crc2 = CRC of block 2 (len2 bytes) -> CRC of block 1 + block 2
+DWORD combine_crc(DWORD crc1, DWORD crc2, DWORD len2)
+{
+  return crc2 ^ crc_multmodp(crc1 ^ CRC32_INIT, crc_x8nmodp(len2));
+}
 
-static DWORD crc_table[256];
+#if (ALG_DEBUG > 2)
+// former byte-wise implementation, kept as reference for the benchmark
+static DWORD crc_table_ref[256];
 
-// generate the table of CRC remainders for all possible bytes
-void gen_crc_table()
+static void gen_crc_table_ref()
 {
   register int i, j;
   register DWORD crc_accum;
@@ -192,24 +568,45 @@ void gen_crc_table()
       else
         crc_accum = (crc_accum << 1);
     }
-    crc_table[i] = crc_accum;
+    crc_table_ref[i] = crc_accum;
   }
   return;
 }
 
-// update the CRC on the data block one byte at a time
-DWORD update_crc(DWORD crc_accum, BYTE *data_blk_ptr, DWORD data_blk_size)
+static DWORD update_crc_ref(DWORD crc_accum, const BYTE *data_blk_ptr, DWORD data_blk_size)
 {
   register DWORD i, j;
 
   for (j = 0; j < data_blk_size; j++)
   {
     i = ((DWORD)(crc_accum >> 24) ^ *data_blk_ptr++) & 0xff;
-    crc_accum = (crc_accum << 8) ^ crc_table[i];
+    crc_accum = (crc_accum << 8) ^ crc_table_ref[i];
   }
   return crc_accum;
 }
 
+// compares result and run time of the slice-by-8 and the byte-wise CRC
+static void crc_benchmark(const BYTE *data_blk_ptr, DWORD data_blk_size)
+{
+  DWORD crc_ref, crc_new, crc_comb;
+  OSTICK t0, t1, t2;
+
+  gen_crc_table_ref();
+  t0 = get_ticks();
+  crc_ref = update_crc_ref(CRC32_INIT, data_blk_ptr, data_blk_size);
+  t1 = get_ticks();
+  crc_new = update_crc(CRC32_INIT, data_blk_ptr, data_blk_size);
+  t2 = get_ticks();
+  crc_comb = combine_crc(update_crc(CRC32_INIT, data_blk_ptr, data_blk_size / 2),
+                         update_crc(CRC32_INIT, data_blk_ptr + data_blk_size / 2, data_blk_size - data_blk_size / 2),
+                         data_blk_size - data_blk_size / 2);
+
+  PRINTF("CRC32 benchmark (%d bytes): byte-wise %d us, slice-by-8 %d us, results %s\n",
+         data_blk_size, (t1 - t0) * system_tick(), (t2 - t1) * system_tick(),
+         (crc_ref == crc_new && crc_ref == crc_comb) ? "match" : "DIFFER");
+}
+#endif
+
 // Algorithm based on the device specs:
 // - RSO-14-006866-05 (Mar/2016)        : Flash serial programming flow
 // - RSO-14-002349-11/TTS-SG-13-0119-03 : Device Type Code of RV40F
@@ -281,6 +678,25 @@ C_RV40F::C_RV40F(DEVPARMS *dparms_p, DEVPINS *dpins_p, DEVSECTORS *dsectors_p,
 {
 
   m_fpga_p = NULL;
+  m_page_sum_p = NULL;
+  m_page_sum_valid_p = NULL;
+  m_sector_crc_p = NULL;
+  m_sector_crc_valid_p = NULL;
+  m_crc_fail_p = NULL;
+  m_block_unchanged_p = NULL;
+  m_fUnchangedValid = false;
+  m_fSysEvtPending = false;
+  m_erase_cmds_saved = 0;
+  m_erase_blocks = 0;
+  m_erase_ms = 0;
+  m_CF_extent_p = NULL;
+  m_DF_extent_p = NULL;
+  m_CF_data_extent_p = NULL;
+  m_CF_extent_cnt = 0;
+  m_DF_extent_cnt = 0;
+  m_CF_data_extent_cnt = 0;
+  m_current_CMD = 0x00;
+  memset(m_wait_hist, 0, sizeof(m_wait_hist));
 
 } //C_RV40F ctor()
 
@@ -294,9 +710,21 @@ C_RV40F::C_RV40F(DEVPARMS *dparms_p, DEVPINS *dpins_p, DEVSECTORS *dsectors_p,
 *******************************************************************************/
 C_RV40F::~C_RV40F()
 {
+#if (ALG_DEBUG > 0)
+  ReportWaitHistogram();
+#endif
 
   delete m_fpga_p;
   m_fpga_p = NULL;
+  delete[] m_page_sum_p;
+  delete[] m_page_sum_valid_p;
+  delete[] m_sector_crc_p;
+  delete[] m_sector_crc_valid_p;
+  delete[] m_crc_fail_p;
+  delete[] m_block_unchanged_p;
+  delete[] m_CF_extent_p;
+  delete[] m_DF_extent_p;
+  delete[] m_CF_data_extent_p;
 }
 
 /*******************************************************************************
@@ -310,7 +738,6 @@ C_RV40F::~C_RV40F()
 void C_RV40F::Initialize(void)
 {
   int i, j;
-  DWORD addrCnt;
   DWORD param;
 
   DWORD fpga_ver = LM_Phapi::Get()->FPGAVerGet();
@@ -342,13 +769,23 @@ void C_RV40F::Initialize(void)
     {
       m_fpga_speedup_supported = true;
 
-      //Bank 0: SOD+LN+WRITE_CMD
-      JTAGBoost_p->SetRAMValues(0x81040113, 0, 0, 0, 32, 0, false);
-      //Bank 1 - 256: 1024 data bytes
-      //MAX_PAGE_SIZE = 1024B = 256 x 4B
-      for (DWORD bank_nr = 1; bank_nr < 256; bank_nr++)
-        JTAGBoost_p->SetRAMValues(0x00000000, 0, 0, 0, 32, bank_nr, false);
-      JTAGBoost_p->SetRAMValues(0x00000000, 0, 0, 0, 32, bank_nr, true); //last frame
+      //Two regions (ping-pong): the next frame is loaded while the device programs the current one.
+      for (BYTE region = 0; region < SEQ_REGIONS; region++)
+      {
+        DWORD base = SEQ_REGION_BASE(region);
+        //Bank 0: frame header (start + LN + command), built per frame in LoadSequencer()
+        JTAGBoost_p->SetRAMValues(0x00000000, 0, 0, 0, 32, base, false);
+        m_seq_header[region] = 0x00000000;
+        //Bank 1 - 256: up to 1024 data bytes
+        //MAX_PAGE_SIZE = 1024B = 256 x 4B
+        for (DWORD bank_nr = 1; bank_nr < SEQ_DATA_BANKS; bank_nr++)
+          JTAGBoost_p->SetRAMValues(0x00000000, 0, 0, 0, 32, base + bank_nr, false);
+        JTAGBoost_p->SetRAMValues(0x00000000, 0, 0, 0, 32, base + SEQ_DATA_BANKS, true); //last frame
+        m_seq_last_bank[region] = SEQ_DATA_BANKS;
+      }
+      m_seq_region = 0;
+      m_seq_staged_p = NULL;
+      m_seq_staged_length = 0;
     }
   }
 
@@ -358,8 +795,10 @@ void C_RV40F::Initialize(void)
   }
 
   m_fTarget_initialized = false;
+  m_fGangInitialized = false;
   m_fStartupMode = false;
   m_reset_H_flmd0_pulse_start_wait = 0;
+  LoadModeEntryCache();
 
   m_sector_quantity = m_devparms_p->sector_quantity;
   for (int block = 0; block < m_sector_quantity; block++)
@@ -407,7 +846,9 @@ void C_RV40F::Initialize(void)
     strcat(msgbuff, "<<Verify mode>> missed, check Database !!!");
     m_prg_api_p->ThrowException(PARAM_UNAVAILABLE_ERR_S, __LINE__, __file, msgbuff);
   }
-  if (param & 2)
+  if (param & 4)
+    m_VerifyType = HYBRID_VERIFY;
+  else if (param & 2)
     m_VerifyType = CHECKSUM_VERIFY;
   else
     m_VerifyType = DATA_VERIFY;
@@ -438,6 +879,61 @@ void C_RV40F::Initialize(void)
     if (param == 0)
       m_fCF_filled0xFF = false;
   }
+
+  //optional: in fill-up mode the 0xFF units of erased blocks are not programmed (the device content is identical)
+  m_fCF_skip0xFF = false; //default
+  if (m_fCF_filled0xFF && m_prg_api_p->SpecFeatureParmGet("Code Flash - skip 0xFF pages", &param))
+  {
+    PRINTF("<<Code Flash - skip 0xFF pages>> found: %Xh \n", param);
+    if (param)
+      m_fCF_skip0xFF = true;
+  }
+
+  //optional: incremental programming - CF blocks, which are already equal to the image (CRC), are skipped
+  m_fIncremental = false; //default
+  if (m_prg_api_p->SpecFeatureParmGet("Incremental programming", &param))
+  {
+    PRINTF("<<Incremental programming>> found: %Xh \n", param);
+    if (param)
+      m_fIncremental = true;
+  }
+
+  //optional: contiguous blocks are erased with one ERASE command (start + end address), if the device accepts it
+  m_fRangeErase = false; //default
+  if (m_prg_api_p->SpecFeatureParmGet("Erase - range command", &param))
+  {
+    PRINTF("<<Erase - range command>> found: %Xh \n", param);
+    if (param)
+      m_fRangeErase = true;
+  }
+
+  //optional: power good / power down delays end as soon as the rails are stable (SO pull-up level, no over-current).
+  //The regulator delay keeps its fixed time: SO follows VIH, not the regulated core supply.
+  m_fPowerSettleDetect = false; //default
+  if (m_prg_api_p->SpecFeatureParmGet("Power - settle detection", &param))
+  {
+    PRINTF("<<Power - settle detection>> found: %Xh \n", param);
+    if (param)
+      m_fPowerSettleDetect = true;
+  }
+
+  //optional: the image read from one socket is compared with all other enabled sockets (odd-one-out detection)
+  m_fReadCompareAll = false; //default
+  if (m_prg_api_p->SpecFeatureParmGet("Read - compare all sockets", &param))
+  {
+    PRINTF("<<Read - compare all sockets>> found: %Xh \n", param);
+    if (param)
+      m_fReadCompareAll = true;
+  }
+
+  //optional: startup frames are shifted by the FPGA at STARTUP_SCI_FREQUENCY instead of bit-banging (SerialWrite)
+  m_fStartupFpgaClock = false; //default
+  if (m_prg_api_p->SpecFeatureParmGet("Startup - FPGA shift clock", &param))
+  {
+    PRINTF("<<Startup - FPGA shift clock>> found: %Xh \n", param);
+    if (param)
+      m_fStartupFpgaClock = true;
+  }
   m_ICU_S_RegionSize = 0;
   m_optionSupportedByDev = 0;
   m_optionSelectedByUser = 0;
@@ -470,39 +966,15 @@ void C_RV40F::Initialize(void)
     m_optionSupportedByDev |= ICU_S_ERASE_PROHIBITED;
 
   //check for selected features
-  for (addrCnt = 0; addrCnt < LB_LENGTH; addrCnt++)
-  {
-    if (GetDataFromRam_8Bit(LOCK_BIT_OFFSET + addrCnt, (DWORD)m_srcdata_bp) != 0xFF)
-    {
-      m_optionSelectedByUser |= LB;
-      break;
-    }
-  }
-  for (addrCnt = 0; addrCnt < LB_LENGTH; addrCnt++)
-  {
-    if (GetDataFromRam_8Bit(OTP_BIT_OFFSET + addrCnt, (DWORD)m_srcdata_bp) != 0xFF)
-    {
-      m_optionSelectedByUser |= OTP;
-      break;
-    }
-  }
+  if (!MemScan_AllEqual(&m_srcdata_bp[LOCK_BIT_OFFSET], LB_LENGTH, 0xFF))
+    m_optionSelectedByUser |= LB;
+  if (!MemScan_AllEqual(&m_srcdata_bp[OTP_BIT_OFFSET], LB_LENGTH, 0xFF))
+    m_optionSelectedByUser |= OTP;
 
-  for (addrCnt = 0; addrCnt < OPBT_LENGTH; addrCnt++)
-  {
-    if (GetDataFromRam_8Bit(OPBT_OFFSET(0) + addrCnt, (DWORD)m_srcdata_bp) != 0xFF)
-    {
-      m_optionSelectedByUser |= OPBT;
-      break;
-    }
-  }
-  for (addrCnt = 0; addrCnt < EXT_OPBT_LENGTH; addrCnt++)
-  {
-    if (GetDataFromRam_8Bit(OPBT_OFFSET(0) + OPBT_LENGTH + addrCnt, (DWORD)m_srcdata_bp) != 0xFF)
-    {
-      m_optionSelectedByUser |= OPBTEX;
-      break;
-    }
-  }
+  if (!MemScan_AllEqual(&m_srcdata_bp[OPBT_OFFSET(0)], OPBT_LENGTH, 0xFF))
+    m_optionSelectedByUser |= OPBT;
+  if (!MemScan_AllEqual(&m_srcdata_bp[OPBT_OFFSET(0) + OPBT_LENGTH], EXT_OPBT_LENGTH, 0xFF))
+    m_optionSelectedByUser |= OPBTEX;
 
   if (GetDataFromRam_8Bit(IDSEL_OFFSET, (DWORD)m_srcdata_bp) == 0x00)
     m_optionSelectedByUser |= ID_CODE;
@@ -513,7 +985,27 @@ void C_RV40F::Initialize(void)
   if (GetDataFromRam_8Bit(SPD_OFFSET, (DWORD)m_srcdata_bp) == 0x00)
     m_optionSelectedByUser |= SPD;
 
-  gen_crc_table();
+#if (ALG_DEBUG > 2)
+  crc_benchmark(m_srcdata_bp, 0x10000);
+#endif
+
+  //job level cache: frame checksum per 1kB CF page and CRC32 per block, filled on first use
+  delete[] m_page_sum_p;
+  delete[] m_page_sum_valid_p;
+  delete[] m_sector_crc_p;
+  delete[] m_sector_crc_valid_p;
+  delete[] m_crc_fail_p;
+  delete[] m_block_unchanged_p;
+  m_page_sum_p = new BYTE[CF_PAGES_IN_IMAGE];
+  m_page_sum_valid_p = new bool[CF_PAGES_IN_IMAGE];
+  m_sector_crc_p = new DWORD[m_sector_quantity];
+  m_sector_crc_valid_p = new bool[m_sector_quantity];
+  m_crc_fail_p = new SOCKET_STATUS_T[m_sector_quantity];
+  m_block_unchanged_p = new bool[m_sector_quantity];
+  memset(m_block_unchanged_p, false, m_sector_quantity * sizeof(bool));
+  InvalidateImageCache();
+
+  BuildExtents();
 
   //m_devparms_p->reserved4 is used for delay settings in Power Up/Down routines
   //LOBYTE = delay setting after Power Up [100ms]
@@ -533,6 +1025,10 @@ void C_RV40F::DoPowerUp(void)
 {
   PRINTF("C_RV40F::DoPowerUp()\n"); // debug statements
 
+  memset(&m_session, 0, sizeof(m_session)); //new session
+  m_fUnchangedValid = false;                 //new part: FindUnchangedBlocks() has to run in Erase() again
+  if (m_block_unchanged_p)
+    memset(m_block_unchanged_p, false, m_sector_quantity * sizeof(bool));
   m_akt_skt_msk = 0;
   for (WORD dut = 0; dut < MAX_SOCKET_NUM; dut++)
   {
@@ -601,16 +1097,17 @@ void C_RV40F::DoPowerUp(void)
   }
   MicroSecDelay(100);
   if (LOBYTE(m_devparms_p->reserved4))
-    DELAY_MS(LOBYTE(m_devparms_p->reserved4) * 100); //wait for regulator stabilisation
+    DELAY_MS(LOBYTE(m_devparms_p->reserved4) * 100); //wait for regulator stabilisation (SO does not track the core supply)
 
   if (m_prg_api_p->PinExists(POWERGOOD_PIN))
     m_prg_api_p->PinSet(POWERGOOD_PIN, LOGIC_1);
-  DELAY_MS(50);
+  WaitPowerSettled("PowerUp - power good", LOGIC_1, 50);
 
   ResetToProgrammingMode();
 
-  if (m_prg_api_p->SysEvtChk())
+  if (m_fSysEvtPending || m_prg_api_p->SysEvtChk()) //event eventually read during WaitPowerSettled()
     PRINTF(" OC @ line %d\n", __LINE__);
+  m_fSysEvtPending = false;
   return;
 }
 
@@ -628,6 +1125,7 @@ void C_RV40F::DoPowerDown(void)
 
   DWORD reset_L_vddoff_wait = 10000;
 
+  ReportSession();
   m_prg_api_p->PinSet(_RESET_PIN, LOGIC_0);
   WaitLoop(reset_L_vddoff_wait);
 
@@ -656,13 +1154,142 @@ void C_RV40F::DoPowerDown(void)
   if (m_prg_api_p->PinExists(VDD_AUX_EN_PIN))
     m_prg_api_p->PinSet(VDD_AUX_EN_PIN, LOGIC_0);
   //m_prg_api_p->SetAdapterPower(HwTypes::OFF);          // Power OFF +5V_SW for testing
-  DELAY_MS(100);
-  if (HIBYTE(m_devparms_p->reserved4))
-    DELAY_MS(HIBYTE(m_devparms_p->reserved4) * 100); //wait for regulator cool down
+  WaitPowerSettled("PowerDown", LOGIC_0, 100 + HIBYTE(m_devparms_p->reserved4) * 100); //wait for regulator cool down
 
+  if (m_fSysEvtPending) //event read during WaitPowerSettled(), must not leak into the next DoPowerUp()
+    PRINTF(" OC @ line %d\n", __LINE__);
+  m_fSysEvtPending = false;
   return;
 }
 
+// Waits max_ms after a power step. With power settle detection the wait ends, as soon as SO (pulled up to VIH)
+// shows pinLvl on all active sockets and no over-current is reported for SETTLE_STABLE_MS.
+// A system event read by SysEvtChk() is kept in m_fSysEvtPending for the caller, then the full max_ms is waited.
+// Returns the time waited [ms].
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+DWORD C_RV40F::WaitPowerSettled(const char *step_p, const WORD pinLvl, const DWORD max_ms)
+{
+  SOCKET_STATUS_T socket_stat;
+  DWORD start_ms, stable_ms, now_ms;
+
+  if (!m_fPowerSettleDetect)
+  {
+    DELAY_MS(max_ms);
+    return max_ms;
+  }
+
+  start_ms = GetTimeMs();
+  stable_ms = start_ms;
+  now_ms = start_ms;
+  while ((now_ms - start_ms) < max_ms)
+  {
+    socket_stat = m_fpga_p->ParDataCompare(pinLvl, 0xFFFE) & m_akt_skt_msk; //D0 = SO
+    if (!m_fSysEvtPending && m_prg_api_p->SysEvtChk())
+      m_fSysEvtPending = true; //reported by the caller's SysEvtChk() check
+    if (CompareFailed(socket_stat) || m_fSysEvtPending)
+      stable_ms = now_ms; //not settled yet: restart the stable time
+    else if ((now_ms - stable_ms) >= SETTLE_STABLE_MS)
+      break;
+    delay(1);
+    now_ms = GetTimeMs();
+  }
+
+  sprintf(msgbuff, "Power settle detection - %s: %d ms (max. %d ms)", step_p, now_ms - start_ms, max_ms);
+  m_prg_api_p->Write2EventLog(msgbuff);
+  return (now_ms - start_ms);
+}
+
+// Looks up the mode entry delay of the device type in MODE_ENTRY_CACHE_FILE.
+// The delay is only taken, if it is still part of RST_H_FLMD0_DLY_LIST. No file, no entry: m_cached_mode_entry_wait = 0.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void C_RV40F::LoadModeEntryCache(void)
+{
+  MODE_ENTRY_CACHE_T entry;
+  FILE *file_p;
+  int i;
+
+  m_cached_mode_entry_wait = 0;
+  file_p = fopen(MODE_ENTRY_CACHE_FILE, "rb");
+  if (file_p == NULL)
+    return;
+
+  while (fread(&entry, sizeof(entry), 1, file_p) == 1)
+  {
+    if (memcmp(entry.TYPE, m_tRV40F_Param_p->TYPE, sizeof(entry.TYPE)) != 0)
+      continue;
+    for (i = 0; i < MODE_ENTRY_DELAY_MAXCNT && m_tRV40F_Param_p->RST_H_FLMD0_DLY_LIST[i]; i++)
+    {
+      if (m_tRV40F_Param_p->RST_H_FLMD0_DLY_LIST[i] == entry.delay)
+        m_cached_mode_entry_wait = entry.delay;
+    }
+    break;
+  }
+  fclose(file_p);
+
+#if (ALG_DEBUG > 0)
+  if (m_cached_mode_entry_wait)
+    PRINTF("C_RV40F::LoadModeEntryCache() - cached mode entry delay: %d us\n", m_cached_mode_entry_wait);
+#endif
+}
+
+// Stores delay as mode entry delay of the device type in MODE_ENTRY_CACHE_FILE (replaces an older entry).
+// delay == 0: the entry of the device type is removed.
+// If the file is full, the oldest entry is dropped. File errors are ignored: the cache is an optimization only.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void C_RV40F::SaveModeEntryCache(const DWORD delay)
+{
+  MODE_ENTRY_CACHE_T entries[MODE_ENTRY_CACHE_MAXCNT];
+  FILE *file_p;
+  int count = 0;
+  int i;
+
+  file_p = fopen(MODE_ENTRY_CACHE_FILE, "rb");
+  if (file_p != NULL)
+  {
+    while (count < MODE_ENTRY_CACHE_MAXCNT && fread(&entries[count], sizeof(entries[0]), 1, file_p) == 1)
+      count++;
+    fclose(file_p);
+  }
+
+  for (i = 0; i < count; i++)
+  {
+    if (memcmp(entries[i].TYPE, m_tRV40F_Param_p->TYPE, sizeof(entries[i].TYPE)) == 0)
+      break;
+  }
+  if (delay == 0) //remove the entry
+  {
+    if (i == count)
+      return; //no entry
+    memmove(&entries[i], &entries[i + 1], (count - i - 1) * sizeof(entries[0]));
+    count--;
+  }
+  else
+  {
+    if (i == MODE_ENTRY_CACHE_MAXCNT) //full: drop the oldest entry
+    {
+      memmove(&entries[0], &entries[1], (MODE_ENTRY_CACHE_MAXCNT - 1) * sizeof(entries[0]));
+      i = MODE_ENTRY_CACHE_MAXCNT - 1;
+    }
+    if (i == count)
+      count++;
+    memcpy(entries[i].TYPE, m_tRV40F_Param_p->TYPE, sizeof(entries[i].TYPE));
+    entries[i].delay = delay;
+  }
+
+  file_p = fopen(MODE_ENTRY_CACHE_FILE, "wb");
+  if (file_p == NULL)
+    return;
+  fwrite(entries, sizeof(entries[0]), count, file_p);
+  fclose(file_p);
+
+  m_cached_mode_entry_wait = delay;
+  if (delay)
+    sprintf(msgbuff, "\tProgramming mode entry delay %d us stored for this device type.", delay);
+  else
+    sprintf(msgbuff, "\tProgramming mode entry delay of this device type removed from the cache.");
+  m_prg_api_p->Write2EventLog(msgbuff);
+}
+
 /*******************************************************************************
 *         C_RV40F::ResetToProgrammingMode ()
 * Inputs:   
@@ -680,7 +1307,9 @@ void C_RV40F::ResetToProgrammingMode(void)
   DWORD flmd_H_reset_H_wait = 10000; //PMT_0F[2]
 
   m_fTarget_initialized = false;
+  m_fGangInitialized = false;
   m_fStartupMode = true;
+  m_session.mode_entries++;
   m_sys_clk = m_op_frequency / 10;                 //[MHz]
   m_fpga_p->SetSerialParams(JP0_0_SI_PIN,          // Serial In -> writing to the device
                             JP0_1_SO_PIN,          // Serial Out-> reading from the deivce
@@ -693,9 +1322,14 @@ void C_RV40F::ResetToProgrammingMode(void)
   //  Devices with the same marking can have different fw versions with different timings,
   //  especially the crucially important reset_H_flmd0_pulse_start_wait.
   //  The loop will try the different delays in the list in th ehope to find the right setting
+  //  A delay already determined (in this session or cached from an earlier one) is tried first.
+  //  If it fails, it is demoted: the list is searched from the beginning, without trying it again.
   int i = 0;
-  if (m_reset_H_flmd0_pulse_start_wait)
-    reset_H_flmd0_pulse_start_wait = m_reset_H_flmd0_pulse_start_wait; //already determined
+  DWORD first_wait = m_reset_H_flmd0_pulse_start_wait ? m_reset_H_flmd0_pulse_start_wait : m_cached_mode_entry_wait;
+  DWORD cached_wait = m_cached_mode_entry_wait; //as stored in MODE_ENTRY_CACHE_FILE
+  DWORD failed_wait = 0;
+  if (first_wait)
+    reset_H_flmd0_pulse_start_wait = first_wait; //already determined
   else
     reset_H_flmd0_pulse_start_wait = m_tRV40F_Param_p->RST_H_FLMD0_DLY_LIST[0];
   do
@@ -743,13 +1377,32 @@ void C_RV40F::ResetToProgrammingMode(void)
       m_reset_H_flmd0_pulse_start_wait = reset_H_flmd0_pulse_start_wait;
     else
     {
-      i++;
+      if (first_wait)
+      { //determined delay does not work anymore (other fw version?): demote it
+        PRINTF("C_RV40F::ResetToProgrammingMode() - mode entry delay %d us failed, searching the list\n", first_wait);
+        failed_wait = first_wait;
+        first_wait = 0;
+        m_reset_H_flmd0_pulse_start_wait = 0;
+        m_cached_mode_entry_wait = 0;
+        i = 0;
+      }
+      else
+        i++;
+      if ((i < MODE_ENTRY_DELAY_MAXCNT) && (m_tRV40F_Param_p->RST_H_FLMD0_DLY_LIST[i] == failed_wait))
+        i++; //already tried
+      if (i == MODE_ENTRY_DELAY_MAXCNT)
+        break; //game over
       reset_H_flmd0_pulse_start_wait = m_tRV40F_Param_p->RST_H_FLMD0_DLY_LIST[i];
     }
-    if ((i == MODE_ENTRY_DELAY_MAXCNT) || (reset_H_flmd0_pulse_start_wait == 0))
+    if (reset_H_flmd0_pulse_start_wait == 0)
       break; //game over
   } while ((socket_stat & m_akt_skt_msk) == m_akt_skt_msk);
 
+  if (m_reset_H_flmd0_pulse_start_wait && (m_reset_H_flmd0_pulse_start_wait != m_cached_mode_entry_wait))
+    SaveModeEntryCache(m_reset_H_flmd0_pulse_start_wait);
+  else if (!m_reset_H_flmd0_pulse_start_wait && failed_wait && (failed_wait == cached_wait))
+    SaveModeEntryCache(0); //demoted and no other delay found: remove the stale entry
+
   return;
 }
 
@@ -874,15 +1527,36 @@ bool C_RV40F::GetSockets_ICU_S_Status()
   return ret_val;
 }
 
+// Returns the mask of the enabled sockets with the given ICU-S status (m_ICU_S_Status).
+// Sockets with different ICU-S status are handled in gang mode per status (at most two passes).
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+BYTE C_RV40F::Get_ICU_S_SocketMask(const int icuStatus)
+{
+  BYTE skt_mask = 0;
+  int nDUT;
+
+  for (nDUT = 0; nDUT < MAX_SOCKET_NUM; nDUT++)
+  {
+    if (m_ICU_S_Status[nDUT] == icuStatus && m_prg_api_p->SocketStatusGet(SocketNumChange(nDUT + 1)) == SOCKET_ENABLE)
+      skt_mask |= 1 << nDUT;
+  }
+
+  return skt_mask;
+}
+
 // SerialWrite(const BYTE* data_p)
 // Used for the initial setup, when low speed is available.
 // The StdWriggler-SerialWrite doesn't work for some devices (the data-hold timing is too short at rising-clk)
 // This function implements the SCI-write sequence properly. Data is latched at rising edge of clk.
+// With m_fStartupFpgaClock the FPGA shifts the byte (symmetrical clock at STARTUP_SCI_FREQUENCY).
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 int C_RV40F::SerialWrite(const BYTE *data_p)
 {
   int i, j;
 
+  if (m_fStartupFpgaClock)
+    return m_fpga_p->SerialWrite((BYTE *)data_p, 8);
+
   for (i = 0; i < 8; i++)
   {
     if ((data_p[0] >> (7 - i)) & 1)
@@ -901,35 +1575,168 @@ int C_RV40F::SerialWrite(const BYTE *data_p)
   return 0;
 }
 
-// Implements the frame format for RV40F devices
-// Load data serially via SI, HS is done via SO
+// Byte sum of a data frame (part of the frame checksum).
+// 1kB code flash pages of the image are summed once per job and then taken from m_page_sum_p.
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
-int C_RV40F::SendFrame(const FRAMESTART_T startType, const FRAMEEND_T endType, const BYTE *buffer_p, const WORD length, BYTE includeACK)
+BYTE C_RV40F::DataSum(const BYTE *buffer_p, const WORD length)
 {
-  DWORD bytecnt;
+  DWORD offset = (DWORD)buffer_p - (DWORD)m_srcdata_bp;
+  DWORD page;
+  BYTE *sum_p;
+  BYTE sum = 0;
+  WORD bytecnt;
+
+  if (m_page_sum_p != NULL && length == MAX_PAGE_SIZE && (DWORD)buffer_p >= (DWORD)m_srcdata_bp &&
+      offset < DF_START_IN_IMAGE && (offset % MAX_PAGE_SIZE) == 0)
+  {
+    page = offset / MAX_PAGE_SIZE;
+    if (m_page_sum_valid_p[page])
+      return m_page_sum_p[page];
+    sum_p = &m_page_sum_p[page];
+    m_page_sum_valid_p[page] = true;
+  }
+  else
+    sum_p = NULL;
+
+  for (bytecnt = 0; bytecnt < length; bytecnt++)
+    sum += buffer_p[bytecnt];
+  if (sum_p != NULL)
+    *sum_p = sum;
+
+  return sum;
+}
+
+// CRC32 of a complete code flash block of the image, calculated once per job.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+DWORD C_RV40F::GetSectorCRC(const WORD block)
+{
+  DWORD startaddress = m_devsectors_p[block].begin_address;
+  DWORD endaddress = m_devsectors_p[block].end_address;
+
+  if (m_sector_crc_p == NULL)
+    return update_crc(CRC32_INIT, &m_srcdata_bp[startaddress], endaddress - startaddress + 1);
+
+  if (!m_sector_crc_valid_p[block])
+  {
+    m_sector_crc_p[block] = update_crc(CRC32_INIT, &m_srcdata_bp[startaddress], endaddress - startaddress + 1);
+    m_sector_crc_valid_p[block] = true;
+  }
+  return m_sector_crc_p[block];
+}
+
+// The image is changed (e.g. by Read()) - all cached checksums have to be recalculated.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void C_RV40F::InvalidateImageCache(void)
+{
+  if (m_page_sum_valid_p != NULL)
+    memset(m_page_sum_valid_p, false, CF_PAGES_IN_IMAGE * sizeof(bool));
+  if (m_sector_crc_valid_p != NULL)
+    memset(m_sector_crc_valid_p, false, m_sector_quantity * sizeof(bool));
+}
+
+// Assembles the complete RV40F frame (start + LN + [ACK] + data + checksum + end) in m_tx_buffer.
+// Returns the frame length in bytes.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+WORD C_RV40F::BuildFrame(const FRAMESTART_T startType, const FRAMEEND_T endType, const BYTE *buffer_p, const WORD length, BYTE includeACK)
+{
+  WORD bytecnt;
   WORD local_length;
-  BYTE data8, checksum = 0;
-  bool ret_value = true;
-  DWORD ulMaxRetries = DEFAULT_TIMEOUT;
-  SOCKET_STATUS_T socket_stat;
+  WORD frameLength = 0;
+  BYTE checksum = 0;
 
   if (includeACK)
     local_length = length + 1;
   else
     local_length = length;
 
-  //synchronize with uC
-  //socket_stat = WaitUntilDeviceReady(m_current_op_mode, LOGIC_0, DEFAULT_TIMEOUT);
-  if (m_current_op_mode == DeviceOperation::READ)
-    m_prg_api_p->SetSocketReadMode(HwTypes::GANG_RD_MODE); //to allow compare function
+  ALG_ASSERT(local_length <= (MAX_PAGE_SIZE + 1));
 
-  do
+  m_tx_buffer[frameLength++] = startType;
+  m_tx_buffer[frameLength++] = HIBYTE(local_length);
+  m_tx_buffer[frameLength++] = LOBYTE(local_length);
+  if (includeACK)
+    m_tx_buffer[frameLength++] = includeACK;
+
+  for (bytecnt = 1; bytecnt < frameLength; bytecnt++) //start byte is not part of the checksum
+    checksum += m_tx_buffer[bytecnt];
+  checksum += DataSum(buffer_p, length);
+
+  memcpy(&m_tx_buffer[frameLength], buffer_p, length);
+  frameLength += length;
+
+  m_tx_buffer[frameLength++] = 0x00 - checksum;
+  m_tx_buffer[frameLength++] = endType;
+
+  return frameLength;
+}
+
+// Loads one region of the FPGA sequencer (F172) with a data frame:
+// bank 0 = start + LN + command/ACK byte, bank 1..n = the 32-bit aligned part of the data.
+// The "last bank" flag is moved only if the frame length differs from the previous one in this region.
+// Return value: count of data bytes covered by the sequencer
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+WORD C_RV40F::LoadSequencer(const BYTE region, const FRAMESTART_T startType, const BYTE *buffer_p, const WORD length, BYTE includeACK)
+{
+  WORD frame_LN = length + 1; //data + command
+  DWORD header = ((DWORD)startType << 24) | ((DWORD)frame_LN << 8) | includeACK;
+  DWORD data_banks = length / 4;
+  DWORD base = SEQ_REGION_BASE(region);
+
+  ALG_ASSERT((data_banks > 0) && (data_banks <= SEQ_DATA_BANKS));
+
+  if (data_banks != m_seq_last_bank[region])
   {
-    socket_stat = m_fpga_p->ParDataCompare(LOGIC_0, 0xFFFE); //D0 = SO
-  } while (ulMaxRetries-- && socket_stat);
+    JTAGBoost_p->SetRAMValues(0x00000000, 0, 0, 0, 32, base + m_seq_last_bank[region], false);
+    JTAGBoost_p->SetRAMValues(0x00000000, 0, 0, 0, 32, base + data_banks, true); //last frame
+    m_seq_last_bank[region] = data_banks;
+  }
+  if (header != m_seq_header[region])
+  {
+    JTAGBoost_p->SetRAMValues(header, 0, 0, 0, 32, base, false);
+    m_seq_header[region] = header;
+  }
+  JTAGBoost_p->SetTDI((DWORD *)buffer_p, data_banks, base + 1);
 
-  if (m_current_op_mode == DeviceOperation::READ)
-    m_prg_api_p->SetSocketReadMode(HwTypes::SINGLE_SKT_RD_MODE);
+  return (WORD)(data_banks * 4);
+}
+
+// true, if the frame can be shifted by the sequencer (see SendFrame)
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+bool C_RV40F::IsSequencerFrame(const BYTE *buffer_p, const WORD length, BYTE includeACK)
+{
+  return (m_fpga_speedup_supported && !m_fStartupMode && includeACK &&
+          (length >= SEQ_MIN_FRAME_SIZE) && (((DWORD)buffer_p & 0x03) == 0));
+}
+
+// Stages the next data frame in the idle sequencer region while the device is still busy with the current one.
+// SendFrame() starts the staged region directly, if it is called with the same frame.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void C_RV40F::PreloadFrame(const FRAMESTART_T startType, const BYTE *buffer_p, const WORD length, BYTE includeACK)
+{
+  BYTE idle_region = m_seq_region ^ 1;
+
+  if (!IsSequencerFrame(buffer_p, length, includeACK))
+    return;
+
+  LoadSequencer(idle_region, startType, buffer_p, length, includeACK);
+  m_seq_staged_p = buffer_p;
+  m_seq_staged_length = length;
+}
+
+// Implements the frame format for RV40F devices
+// Load data serially via SI, HS is done via SO
+// The frame is built in m_tx_buffer and handed to the wiggler as a single bulk shift.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+int C_RV40F::SendFrame(const FRAMESTART_T startType, const FRAMEEND_T endType, const BYTE *buffer_p, const WORD length, BYTE includeACK)
+{
+  DWORD bytecnt;
+  WORD frameLength;
+  BYTE checksum = 0;
+  bool ret_value = true;
+  SOCKET_STATUS_T socket_stat;
+
+  //synchronize with uC
+  socket_stat = WaitUntilDeviceReady(m_current_op_mode, LOGIC_0, DEFAULT_TIMEOUT_MS);
 
   if (CompareFailed(socket_stat))
   {
@@ -940,407 +1747,601 @@ int C_RV40F::SendFrame(const FRAMESTART_T startType, const FRAMEEND_T endType, c
     }
   }
 
-  if (length == MAX_PAGE_SIZE && m_fpga_speedup_supported)
+  // Data frames (with command/ACK byte) of a reasonable size are shifted by the sequencer:
+  // header + 32-bit aligned data. The rest of the data, checksum and end of frame follow via the wiggler.
+  // The regions are used alternately; the idle one may already hold this frame (PreloadFrame).
+  if (IsSequencerFrame(buffer_p, length, includeACK))
   {
-    JTAGBoost_p->SetTDI((DWORD *)buffer_p, MAX_PAGE_SIZE / 4, 1);
-    JTAGBoost_p->StartOp(0);
-    checksum = 0x18; //(0x04 + 0x01 (LN)) + 0x13 (Program_CMD)
-    for (bytecnt = 0; bytecnt < MAX_PAGE_SIZE; bytecnt++)
-      checksum += buffer_p[bytecnt];
+    m_seq_region ^= 1;
+    if (buffer_p == m_seq_staged_p && length == m_seq_staged_length &&
+        m_seq_header[m_seq_region] == (((DWORD)startType << 24) | ((DWORD)(length + 1) << 8) | includeACK))
+      bytecnt = (length / 4) * 4;
+    else
+      bytecnt = LoadSequencer(m_seq_region, startType, buffer_p, length, includeACK);
+    m_seq_staged_p = NULL;
+    JTAGBoost_p->StartOp(SEQ_REGION_BASE(m_seq_region));
+    checksum = (BYTE)((length + 1) >> 8) + (BYTE)(length + 1) + includeACK + DataSum(buffer_p, length);
+
+    //trailer: remaining data bytes + checksum + end of frame
+    frameLength = 0;
+    for (; bytecnt < length; bytecnt++)
+      m_tx_buffer[frameLength++] = buffer_p[bytecnt];
+    m_tx_buffer[frameLength++] = 0x00 - checksum;
+    m_tx_buffer[frameLength++] = endType;
+    m_fpga_p->SerialWrite(&m_tx_buffer[0], 8 * frameLength);
+    return ret_value;
   }
-  else
+
+  frameLength = BuildFrame(startType, endType, buffer_p, length, includeACK);
+  if (m_fStartupMode && !m_fStartupFpgaClock)
   {
-    //-----------------------------------------------------//
-    if (m_fStartupMode)
-      SerialWrite((BYTE *)&startType);
-    else
-      m_fpga_p->SerialWrite((BYTE *)&startType, 8);
-    //-----------------------------------------------------//
-    data8 = HIBYTE(local_length);
-    checksum += data8;
-    if (m_fStartupMode)
-      SerialWrite(&data8);
-    else
-      m_fpga_p->SerialWrite(&data8, 8);
-    //-----------------------------------------------------//
-    data8 = LOBYTE(local_length);
-    checksum += data8;
-    if (m_fStartupMode)
-      SerialWrite(&data8);
-    else
-      m_fpga_p->SerialWrite(&data8, 8);
-    //-----------------------------------------------------//
-    if (includeACK)
-    {
-      checksum += includeACK;
-      if (m_fStartupMode)
-        SerialWrite(&includeACK);
-      else
-        m_fpga_p->SerialWrite(&includeACK, 8);
-    }
-    //-----------------------------------------------------//
-    for (bytecnt = 0; bytecnt < length; bytecnt++)
-    {
-      checksum += buffer_p[bytecnt];
-      if (m_fStartupMode)
-        SerialWrite(&buffer_p[bytecnt]);
-      else
-        m_fpga_p->SerialWrite(&buffer_p[bytecnt], 8);
-    }
+    for (bytecnt = 0; bytecnt < frameLength; bytecnt++)
+      SerialWrite(&m_tx_buffer[bytecnt]);
   }
-  //-----------------------------------------------------//
-  checksum = 0x00 - checksum;
-  if (m_fStartupMode)
-    SerialWrite(&checksum);
   else
-    m_fpga_p->SerialWrite(&checksum, 8);
-  //-----------------------------------------------------//
-  if (m_fStartupMode)
-    SerialWrite((BYTE *)&endType);
-  else
-    m_fpga_p->SerialWrite((BYTE *)&endType, 8);
+    m_fpga_p->SerialWrite(&m_tx_buffer[0], 8 * frameLength);
 
   return ret_value;
 }
 
 ///////////////////////////////////////////////////////////////////////
-//WaitUntilDeviceReady(DEV_OP_E opMode, const WORD pinLvl, DWORD timeout)
+//WaitUntilDeviceReady(DEV_OP_E opMode, const WORD pinLvl, DWORD timeout_ms)
 //
 //Waits for the READY signal on SO (the level depends on the send or receive state)
+//The first READY_SPIN_POLLS polls are done back-to-back (short handshakes), then the
+//delay between two polls is doubled up to READY_BACKOFF_MAX_US. Longer waits (erase, program)
+//poll once per ms and leave the CPU to other processes.
+//The wait time is recorded per command (m_current_CMD) in m_wait_hist.
 ///////////////////////////////////////////////////////////////////////
-BYTE C_RV40F::WaitUntilDeviceReady(DEV_OP_E opMode, const WORD pinLvl, DWORD timeout)
+BYTE C_RV40F::WaitUntilDeviceReady(DEV_OP_E opMode, const WORD pinLvl, DWORD timeout_ms)
 {
   BYTE socket_stat;
+  DWORD start_ms = GetTimeMs();
+  DWORD elapsed_ms = 0;
+  DWORD polls = 0;
+  WORD backoff_us = 1;
 
   if (opMode == DeviceOperation::READ)
     m_prg_api_p->SetSocketReadMode(HwTypes::GANG_RD_MODE); //to allow compare function
-  do
+  for (;;)
   {
     socket_stat = m_fpga_p->ParDataCompare(pinLvl, 0xFFFE); //D0 = SO
-  } while (timeout-- && socket_stat);
+    if (ComparePassed(socket_stat))
+      break;
+    elapsed_ms = GetTimeMs() - start_ms;
+    if (elapsed_ms >= timeout_ms)
+      break;
+    if (++polls <= READY_SPIN_POLLS)
+      continue;
+    if (backoff_us < READY_BACKOFF_MAX_US)
+    {
+      MicroSecDelay(backoff_us);
+      backoff_us <<= 1;
+    }
+    else if (timeout_ms > DEFAULT_TIMEOUT_MS) //long waits (erase): OS delay, tick granularity
+      delay(1);
+    else //page status waits: keep polling at READY_BACKOFF_MAX_US
+      MicroSecDelay(READY_BACKOFF_MAX_US);
+  }
   if (opMode == DeviceOperation::READ)
     m_prg_api_p->SetSocketReadMode(HwTypes::SINGLE_SKT_RD_MODE);
 
+  RecordWaitTime(m_current_CMD, GetTimeMs() - start_ms);
+
   return socket_stat;
 }
 
-// Implements the frame format for RV40F devices
-// Verify data received serially via SO against data in buffer_p
-// The return value is false, if an error occured and all sockets are wrong.
-// It does not matter which part of the frame failed, the appropriated socket is switched off.
-// In our "closed" gang environment this makes sense. In ICP/ISP (or single socket programming),
-// the different error codes could be cheked. Then the further process could be decided based on the error code (checksum error, or BUSY code)
-// Parameter: check_length: count of bytes to be checked in the data frame. If it is lower than length, the rest of data bytes would be ignored.
-//            inlcudeACK:   before receiving data, check ACK code
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
-int C_RV40F::GetDataFrame(const FRAMEEND_T endType, BYTE *buffer_p, const WORD length, const WORD check_length, BYTE includeACK, bool fLongWait)
+DWORD C_RV40F::GetTimeMs(void)
 {
-  int ret_value = true;
-  WORD local_length;
-  SOCKET_STATUS_T socket_stat;
-  BYTE checksum = 0;
-  BYTE expectedData, readData;
-  DWORD bytecnt;
-  DWORD ulMaxRetries;
-
-  if (fLongWait)
-    ulMaxRetries = ERASE_TIMEOUT;
-  else
-    ulMaxRetries = DEFAULT_TIMEOUT;
-
-  if (includeACK)
-    local_length = length + 1;
-  else
-    local_length = length;
+  return (DWORD)(((unsigned long long)get_ticks() * system_tick()) / 1000);
+}
 
-  //synchronize with uC
-  //socket_stat = WaitUntilDeviceReady(m_current_op_mode, LOGIC_1, ulMaxRetries);
-  if (m_current_op_mode == DeviceOperation::READ)
-    m_prg_api_p->SetSocketReadMode(HwTypes::GANG_RD_MODE); //to allow compare function
+// Histogram of the ready wait times per command: bucket 0 = < 1ms, bucket n = 2^(n-1) .. 2^n - 1 ms
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void C_RV40F::RecordWaitTime(const BYTE cmd, DWORD wait_ms)
+{
+  BYTE bucket = 0;
 
-  do
+  while (wait_ms && bucket < (WAIT_HIST_BUCKETS - 1))
   {
-    socket_stat = m_fpga_p->ParDataCompare(LOGIC_1, 0xFFFE); //D0 = SO
-  } while (ulMaxRetries-- && socket_stat);
+    wait_ms >>= 1;
+    bucket++;
+  }
+  m_wait_hist[cmd & 0x7F][bucket]++;
+}
 
-  if (m_current_op_mode == DeviceOperation::READ)
-    m_prg_api_p->SetSocketReadMode(HwTypes::SINGLE_SKT_RD_MODE);
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void C_RV40F::ReportWaitHistogram(void)
+{
+  WORD cmd;
+  BYTE bucket;
 
-  if (CompareFailed(socket_stat))
+  for (cmd = 0; cmd < WAIT_HIST_CMDS; cmd++)
   {
-    if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, LOGIC_1))
-    {
-      m_prg_api_p->Write2EventLog("C_RV40F::GetFrame timeout error!");
-      return false;
-    }
+    for (bucket = 0; bucket < WAIT_HIST_BUCKETS; bucket++)
+      if (m_wait_hist[cmd][bucket])
+        break;
+    if (bucket == WAIT_HIST_BUCKETS)
+      continue; //no waits for this command
+
+    PRINTF("C_RV40F: SO ready wait for cmd %Xh [ms: count]:", cmd);
+    for (bucket = 0; bucket < WAIT_HIST_BUCKETS; bucket++)
+      if (m_wait_hist[cmd][bucket])
+        PRINTF(" <%d: %d", 1 << bucket, m_wait_hist[cmd][bucket]);
+    PRINTF("\n");
   }
+}
 
-  // Frame Header
-  expectedData = SOD;
-  if (m_current_op_mode == DeviceOperation::READ)
-  {
-    if (m_fpga_p->SerialRead(&readData, 8))
-      return false;
-    else if (readData != expectedData)
-    {
-      PRINTF("C_RV40F::GetDataFrame() - Check status for cmd %Xh failed. SOD not recognized. Expected: %Xh, Actual: %Xh\n", (WORD)m_current_CMD, expectedData, readData);
-      return false; //frame must fit
-    }
-  }
-  else //VERIFYMODE
-    socket_stat = m_fpga_p->SerialCompare(&expectedData, &COMPARE_ALL_MASK, 8);
+// Compares a complete frame received via SO against the expected frame in m_tx_buffer.
+// m_cmp_mask holds the compare mask per frame byte (COMPARE_ALL_MASK / COMPARE_NOTHING / marker).
+// The frame is shifted in granules of COMPARE_GRANULE bytes, so the first failing granule of every socket is known.
+// Return value: mask of failing sockets; m_first_fail_offset[] = frame offset of the first failing granule
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+SOCKET_STATUS_T C_RV40F::CompareFrame(const WORD frameLength)
+{
+  SOCKET_STATUS_T fail_stat = 0;
+  SOCKET_STATUS_T socket_stat;
+  WORD offset, granule;
+  int skt;
 
-  if (CompareFailed(socket_stat))
-  {
-    PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. SOD not recognized.\n", (WORD)m_current_CMD);
-    if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, expectedData))
-      return false;
-  }
+  for (skt = 0; skt < MAX_SOCKET_NUM; skt++)
+    m_first_fail_offset[skt] = NO_FAIL_OFFSET;
 
-  expectedData = HIBYTE(local_length);
-  checksum += expectedData;
-  if (m_current_op_mode == DeviceOperation::READ)
+  for (offset = 0; offset < frameLength; offset += granule)
   {
-    if (m_fpga_p->SerialRead(&readData, 8))
-      return false;
-    else if (readData != expectedData)
+    granule = (frameLength - offset < COMPARE_GRANULE) ? (frameLength - offset) : COMPARE_GRANULE;
+    socket_stat = m_fpga_p->SerialCompare(&m_tx_buffer[offset], &m_cmp_mask[offset], 8 * granule);
+    if (socket_stat & ~fail_stat)
     {
-      PRINTF("C_RV40F::GetDataFrame() - Check status for cmd %Xh failed. Unexpected frame length (MSB). Expected: %Xh, Actual: %Xh\n", (WORD)m_current_CMD, expectedData, readData);
-      return false; //frame must fit
+      for (skt = 0; skt < MAX_SOCKET_NUM; skt++)
+      {
+        if ((socket_stat & ~fail_stat) & (1 << skt))
+          m_first_fail_offset[skt] = offset;
+      }
+      fail_stat |= socket_stat;
     }
   }
-  else //VERIFYMODE
-    socket_stat = m_fpga_p->SerialCompare(&expectedData, &COMPARE_ALL_MASK, 8);
-  if (CompareFailed(socket_stat))
-  {
-    PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Unexpected frame length.\n", (WORD)m_current_CMD);
-    if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, expectedData))
-      return false;
-  }
 
-  expectedData = LOBYTE(local_length);
-  checksum += expectedData;
-  if (m_current_op_mode == DeviceOperation::READ)
-  {
-    if (m_fpga_p->SerialRead(&readData, 8))
-      return false;
-    else if (readData != expectedData)
-    {
-      PRINTF("C_RV40F::GetDataFrame() - Check status for cmd %Xh failed. Unexpected frame length (LSB). Expected: %Xh, Actual: %Xh\n", (WORD)m_current_CMD, expectedData, readData);
-      return false; //frame must fit
-    }
-  }
-  else //VERIFYMODE
-    socket_stat = m_fpga_p->SerialCompare(&expectedData, &COMPARE_ALL_MASK, 8);
-  if (CompareFailed(socket_stat))
+  return fail_stat;
+}
+
+// Disables the sockets of socket_stat (MisCompare) after a failed CompareFrame(). The reported address is the
+// first failing granule of each socket: baseAddress + offset in the data part of the frame (after headerLength bytes).
+// Return value: false, if no socket is left.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+bool C_RV40F::MisCompareFrame(const SOCKET_STATUS_T socket_stat, const DWORD baseAddress, const WORD headerLength)
+{
+  bool fSocketsLeft = true;
+  DWORD address;
+  int skt;
+
+  for (skt = 0; skt < MAX_SOCKET_NUM; skt++)
   {
-    PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Unexpected frame length.\n", (WORD)m_current_CMD);
-    if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, expectedData))
-      return false;
+    if (!(socket_stat & (1 << skt)))
+      continue;
+    address = baseAddress;
+    if (m_first_fail_offset[skt] != NO_FAIL_OFFSET && m_first_fail_offset[skt] > headerLength)
+      address += m_first_fail_offset[skt] - headerLength;
+
+    sprintf(msgbuff, "\tSocket%d: cmd %Xh, frame compare failed at 0x%08X.", SocketNumChange(skt + 1), (WORD)m_current_CMD, address);
+    m_prg_api_p->Write2EventLog(msgbuff);
+    fSocketsLeft = m_prg_api_p->MisCompare(m_current_op_mode, (SOCKET_STATUS_T)(1 << skt), address, 0);
   }
 
+  return fSocketsLeft;
+}
+
+// Implements the frame format for RV40F devices
+// Verify data received serially via SO against data in buffer_p
+// The return value is false, if an error occured and all sockets are wrong.
+// It does not matter which part of the frame failed, the appropriated socket is switched off.
+// In our "closed" gang environment this makes sense. In ICP/ISP (or single socket programming),
+// the different error codes could be cheked. Then the further process could be decided based on the error code (checksum error, or BUSY code)
+// Parameter: check_length: count of bytes to be checked in the data frame. If it is lower than length, the rest of data bytes would be ignored.
+//            inlcudeACK:   before receiving data, check ACK code
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+int C_RV40F::GetDataFrame(const FRAMEEND_T endType, BYTE *buffer_p, const WORD length, const WORD check_length, BYTE includeACK, bool fLongWait)
+{
+  int ret_value = true;
+  WORD local_length;
+  WORD frameLength;
+  SOCKET_STATUS_T socket_stat;
+  DWORD timeout_ms = fLongWait ? ERASE_TIMEOUT_MS : DEFAULT_TIMEOUT_MS;
+
   if (includeACK)
-  {
-    checksum += includeACK;
-    if (m_current_op_mode == DeviceOperation::READ)
-    {
-      if (m_fpga_p->SerialRead(&readData, 8))
-        return false;
-      else if (readData != includeACK)
-      {
-        PRINTF("C_RV40F::GetDataFrame() - Check status for cmd %Xh failed. Expected ACK code: %Xh, Actual: %Xh\n", (WORD)m_current_CMD, includeACK, readData);
-        return false; //frame must fit
-      }
-    }
-    else //VERIFYMODE
-      socket_stat = m_fpga_p->SerialCompare(&includeACK, &COMPARE_ALL_MASK, 8);
-    if (CompareFailed(socket_stat))
-    {
-      PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Unexpected ACK code.\n", (WORD)m_current_CMD);
-      if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, includeACK))
-        return false;
-    }
-  } //-- OF if (includeACK)
+    local_length = length + 1;
+  else
+    local_length = length;
 
-  // Parameter
-  for (bytecnt = 0; bytecnt < length; bytecnt++)
+  if (m_current_op_mode == DeviceOperation::READ) //READMODE: receive the frame, then check it
   {
-    if (m_current_op_mode == DeviceOperation::READ)
+    if (false == ReceiveFrame(&m_comm_buffer[0], &frameLength, timeout_ms))
+      return false;
+    if (frameLength != local_length)
     {
-      if (m_fpga_p->SerialRead(&buffer_p[bytecnt], 8))
-        ret_value = false;
-      checksum += buffer_p[bytecnt];
+      PRINTF("C_RV40F::GetDataFrame() - Check status for cmd %Xh failed. Unexpected frame length. Expected: %Xh, Actual: %Xh\n", (WORD)m_current_CMD, local_length, frameLength);
+      return false; //frame must fit
     }
-    else //VERIFYMODE
+    if (includeACK && m_comm_buffer[3] != includeACK)
     {
-      checksum += buffer_p[bytecnt];
-      expectedData = buffer_p[bytecnt];
-      socket_stat = m_fpga_p->SerialCompare(&expectedData, &COMPARE_ALL_MASK, 8);
-    }
-
-    if (CompareFailed(socket_stat))
-    {
-      if (check_length == length || bytecnt < check_length)
-      {
-        PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Unexpected data.\n", (WORD)m_current_CMD);
-        if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, expectedData))
-          return false;
-      }
+      PRINTF("C_RV40F::GetDataFrame() - Check status for cmd %Xh failed. Expected ACK code: %Xh, Actual: %Xh\n", (WORD)m_current_CMD, includeACK, m_comm_buffer[3]);
+      return false; //frame must fit
     }
-  }
-
-  // Check sum
-  expectedData = 0x00 - checksum;
-  if (m_current_op_mode == DeviceOperation::READ)
-  {
-    if (m_fpga_p->SerialRead(&readData, 8))
-      ret_value = false;
-    else if (readData != expectedData)
+    if (m_comm_buffer[frameLength + 4] != endType)
     {
-      PRINTF("C_RV40F::GetDataFrame() - Check status for cmd %Xh failed. Unexpected checksum. Expected: %Xh, Actual: %Xh\n", (WORD)m_current_CMD, expectedData, readData);
+      PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Frame end mark not recognized.\n", (WORD)m_current_CMD);
       return false; //frame must fit
     }
+    memcpy(buffer_p, &m_comm_buffer[includeACK ? 4 : 3], length);
+    return ret_value;
   }
-  else //VERIFYMODE
-    socket_stat = m_fpga_p->SerialCompare(&expectedData, &COMPARE_ALL_MASK, 8);
+
+  //synchronize with uC
+  socket_stat = WaitUntilDeviceReady(m_current_op_mode, LOGIC_1, timeout_ms);
+
   if (CompareFailed(socket_stat))
   {
-    if (check_length == length)
+    if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, LOGIC_1))
     {
-      PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Unexpected checksum.\n", (WORD)m_current_CMD);
-      if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, expectedData))
-        return false;
-    }
-  }
-
-  // End of frame
-  expectedData = endType;
-  if (m_current_op_mode == DeviceOperation::READ)
-  {
-    if (m_fpga_p->SerialRead(&readData, 8))
+      m_prg_api_p->Write2EventLog("C_RV40F::GetFrame timeout error!");
       return false;
-    else if (readData != expectedData)
-    {
-      PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Frame end mark not recognized.\n", (WORD)m_current_CMD);
-      return false; //frame must fit
     }
   }
-  else //VERIFYMODE
-    socket_stat = m_fpga_p->SerialCompare(&expectedData, &COMPARE_ALL_MASK, 8);
+
+  //VERIFYMODE: compare the complete frame at once
+  frameLength = BuildFrame(SOD, endType, buffer_p, length, includeACK);
+  memset(&m_cmp_mask[0], COMPARE_ALL_MASK, frameLength);
+  if (check_length < length) //ignore the rest of data bytes and the checksum
+    memset(&m_cmp_mask[frameLength - 2 - (length - check_length)], COMPARE_NOTHING, length - check_length + 1);
+
+  socket_stat = CompareFrame(frameLength);
   if (CompareFailed(socket_stat))
   {
-    PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Frame end mark not recognized.\n", (WORD)m_current_CMD);
-    if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, expectedData))
+    PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Unexpected frame data.\n", (WORD)m_current_CMD);
+    if (!MisCompareFrame(socket_stat, 0, includeACK ? 4 : 3)) //address: offset in the data
       return false;
   }
 
   return ret_value;
 }
 
+// Compares the next frame of all sockets with the expected frame (VERIFYMODE only).
+// Other than GetDataFrame() the failing sockets are not disabled: the return value holds the sockets,
+// which timed out or sent different data.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+SOCKET_STATUS_T C_RV40F::CompareDataFrame(const FRAMEEND_T endType, BYTE *buffer_p, const WORD length, const WORD check_length, BYTE includeACK, DWORD timeout_ms)
+{
+  SOCKET_STATUS_T timeout_stat;
+  WORD frameLength;
+
+  //synchronize with uC
+  timeout_stat = WaitUntilDeviceReady(m_current_op_mode, LOGIC_1, timeout_ms);
+
+  frameLength = BuildFrame(SOD, endType, buffer_p, length, includeACK);
+  memset(&m_cmp_mask[0], COMPARE_ALL_MASK, frameLength);
+  if (check_length < length) //ignore the rest of data bytes and the checksum
+    memset(&m_cmp_mask[frameLength - 2 - (length - check_length)], COMPARE_NOTHING, length - check_length + 1);
+
+  return (timeout_stat | CompareFrame(frameLength));
+}
+
+// Gang mode: sends the command cmd to all enabled sockets and compares the status frame and the data frame
+// (expected_p: length bytes, the first check_length bytes are compared) in one pass of the compare engine.
+// Returns the sockets, which have to be read back socket by socket (all of them, if any status failed).
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+SOCKET_STATUS_T C_RV40F::GangCompareCmd(const BYTE cmd, BYTE *expected_p, const WORD length, const WORD check_length)
+{
+  SOCKET_STATUS_T all_skt_mask = (SOCKET_STATUS_T)LM_Phapi::Get()->ActiveDUTMaskGet();
+  BYTE ack = cmd;
+
+  m_current_CMD = cmd;
+  if (false == SendFrame(SOH, ETX, &ack, 1))
+    return all_skt_mask;
+  if (CompareFailed(CompareDataFrame(ETX, &ack, CHECK_ST1, CHECK_ST1)))
+    return all_skt_mask; //sockets in different protocol states: read back each one
+
+  if (false == SendFrame(SOD, ETX, &ack, 1)) //reverse ACK
+    return all_skt_mask;
+
+  return CompareDataFrame(ETX, expected_p, length, check_length, cmd);
+}
+
 // Implements the frame format for RV40F devices
-// Works in READ mode only (NO GANG mode). Saves the data in buffer_p - make sure the buffer is big enough!
-// The return value is false, if a communication error occured.
+// Works in READ mode only (NO GANG mode). Synchronizes with the uC and receives the frame header in frame_p:
+// frame_p[0] = SOD, [1..2] = LN (headerLength = 3), [3] = ACK/error code (headerLength = 4).
+// *length_p = LN, *checksum_p = sum of the received header bytes after SOD (LN [+ ACK]).
+// The return value is false, if a communication error occured or the header is invalid.
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
-int C_RV40F::ReadDataFrame(BYTE *buffer_p)
+int C_RV40F::ReceiveFrameHeader(BYTE *frame_p, const WORD headerLength, WORD *length_p, BYTE *checksum_p, DWORD timeout_ms)
 {
   WORD length;
-  DWORD bytecnt;
-  BYTE checksum;
-  BYTE local_buffer[4];
+  WORD bytecnt;
+  BYTE checksum = 0;
   SOCKET_STATUS_T socket_stat;
-  DWORD ulMaxRetries = DEFAULT_TIMEOUT;
-  int ret_value = true;
 
   //synchronize with uC
-  socket_stat = WaitUntilDeviceReady(m_current_op_mode, LOGIC_1, DEFAULT_TIMEOUT);
+  socket_stat = WaitUntilDeviceReady(m_current_op_mode, LOGIC_1, timeout_ms);
 
   if (CompareFailed(socket_stat))
   {
     if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, LOGIC_1))
     {
-      m_prg_api_p->Write2EventLog("C_RV40F::ReadFrame timeout error!");
+      m_prg_api_p->Write2EventLog("C_RV40F::ReceiveFrame timeout error!");
       return false;
     }
   }
 
-  // Read first 3 bytes: SOD + LN(2)
-  if (m_fpga_p->SerialRead(&local_buffer[0], 24))
+  if (m_fpga_p->SerialRead(&frame_p[0], 8 * headerLength))
     return false;
-  length = ((WORD)local_buffer[1] << 8) | (WORD)local_buffer[2];
-  if (length > (MAX_PAGE_SIZE + 1)) //RES + max. LEN
+  if (frame_p[0] != SOD)
+  {
+    PRINTF("C_RV40F::ReceiveFrame() - cmd %Xh: SOD not recognized. Actual: %Xh\n", (WORD)m_current_CMD, frame_p[0]);
+    return false;
+  }
+  length = ((WORD)frame_p[1] << 8) | (WORD)frame_p[2];
+  if ((length + 3) < headerLength || length > (MAX_PAGE_SIZE + 1)) //ACK within LN; RES + max. LEN
   {
-    m_prg_api_p->Write2EventLog("C_RV40F::ReadFrame size exceeded buffer limit.");
+    m_prg_api_p->Write2EventLog("C_RV40F::ReceiveFrame invalid frame header.");
     return false;
   }
-  checksum = local_buffer[1] + local_buffer[2];
+  for (bytecnt = 1; bytecnt < headerLength; bytecnt++)
+    checksum += frame_p[bytecnt];
 
-  // Parameter
-  for (bytecnt = 0; bytecnt < length; bytecnt++)
+  *length_p = length;
+  *checksum_p = checksum;
+  return true;
+}
+
+// Implements the frame format for RV40F devices
+// Works in READ mode only (NO GANG mode). Receives a complete frame in frame_p - the buffer must hold COM_BUFFER_SIZE bytes!
+// frame_p[0] = SOD, [1..2] = LN, [3..LN+2] = data (incl. ACK/error code), [LN+3] = CS, [LN+4] = end of frame
+// After LN is decoded the rest of the frame is read in one transfer. *length_p = LN
+// The return value is false, if a communication error occured.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+int C_RV40F::ReceiveFrame(BYTE *frame_p, WORD *length_p, DWORD timeout_ms)
+{
+  WORD length;
+  WORD bytecnt;
+  BYTE checksum;
+
+  // SOD + LN(2)
+  if (false == ReceiveFrameHeader(frame_p, 3, &length, &checksum, timeout_ms))
+    return false;
+
+  // Data + CS + end of frame
+  if (m_fpga_p->SerialRead(&frame_p[3], 8 * (length + 2)))
+    return false;
+
+  for (bytecnt = 3; bytecnt <= (length + 3); bytecnt++) //data + CS
+    checksum += frame_p[bytecnt];
+  if (checksum)
   {
-    if (m_fpga_p->SerialRead(&buffer_p[bytecnt], 8))
-      return false;
-    checksum += buffer_p[bytecnt];
+    sprintf(msgbuff, "C_RV40F::ReceiveFrame checksum ERROR while executing cmd 0x%02X.", frame_p[3]);
+    m_prg_api_p->Write2EventLog(msgbuff);
+    return false;
   }
 
-  // Check sum
-  if (m_fpga_p->SerialRead(&local_buffer[0], 8))
+  *length_p = length;
+  return true;
+}
+
+// Implements the frame format for RV40F devices
+// Works in READ mode only (NO GANG mode). Header (SOD + LN + ACK) and trailer (CS + end of frame) are received
+// in m_comm_buffer, the data of a frame with ACK = ackCode is received directly at data_p (max. dataSpace bytes).
+// Other frames (error codes) are received completely in m_comm_buffer (see ReceiveFrame).
+// *length_p = LN; m_comm_buffer[3] = ACK/error code
+// The return value is false, if a communication error occured.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+int C_RV40F::ReceiveFrameToImage(const BYTE ackCode, BYTE *data_p, const DWORD dataSpace, WORD *length_p)
+{
+  WORD length;
+  WORD bytecnt;
+  BYTE checksum;
+
+  // SOD + LN(2) + ACK
+  if (false == ReceiveFrameHeader(&m_comm_buffer[0], 4, &length, &checksum))
     return false;
-  checksum += local_buffer[0];
+
+  if (m_comm_buffer[3] == ackCode)
+  { // data -> image, CS + end of frame -> m_comm_buffer[4..5]
+    if ((DWORD)(length - 1) > dataSpace)
+    {
+      m_prg_api_p->Write2EventLog("C_RV40F::ReceiveFrame data exceeds the requested area.");
+      return false;
+    }
+    if (m_fpga_p->SerialRead(data_p, 8 * (length - 1)))
+      return false;
+    if (m_fpga_p->SerialRead(&m_comm_buffer[4], 16))
+      return false;
+    for (bytecnt = 0; bytecnt < (length - 1); bytecnt++)
+      checksum += data_p[bytecnt];
+    checksum += m_comm_buffer[4];
+  }
+  else
+  { // complete frame -> m_comm_buffer
+    if (m_fpga_p->SerialRead(&m_comm_buffer[4], 8 * (length + 1)))
+      return false;
+    for (bytecnt = 4; bytecnt <= (length + 3); bytecnt++) //data + CS
+      checksum += m_comm_buffer[bytecnt];
+  }
+
   if (checksum)
   {
-    sprintf(msgbuff, "C_RV40F::ReadFrame checksum ERROR while executing cmd 0x%02X.", buffer_p[0]);
+    sprintf(msgbuff, "C_RV40F::ReceiveFrame checksum ERROR while executing cmd 0x%02X.", m_comm_buffer[3]);
     m_prg_api_p->Write2EventLog(msgbuff);
     return false;
   }
-  // End of frame
-  if (m_fpga_p->SerialRead(&local_buffer[1], 8))
+
+  *length_p = length;
+  return true;
+}
+
+// Sets the MARKER for valid data of a contiguous range in the image -> then the image can be used for LFM jobs.
+// fValid == false: the range is marked as without data (0xFF), e.g. before it is read.
+// Code flash: every MIN_PAGE_SIZE page touched by the range is marked.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void C_RV40F::MarkImageValid(const WORD block, const DWORD startaddress, const DWORD size, const bool fValid)
+{
+  BYTE marker = fValid ? 0x00 : 0xFF;
+
+  if (size == 0 || m_DF_write_unit == 16)
+    return;
+
+  if (block >= m_DF_block_nr)
+    memset(&m_srcdata_bp[DF_MARKER_OFFSET + startaddress], marker, size);
+  else
+    memset(&m_srcdata_bp[CF_MARKER_OFFSET + (startaddress / MIN_PAGE_SIZE)], marker,
+           (startaddress + size - 1) / MIN_PAGE_SIZE - startaddress / MIN_PAGE_SIZE + 1);
+}
+
+// Implements the frame format for RV40F devices
+// Works in READ mode only (NO GANG mode). Saves the data in buffer_p - make sure the buffer is big enough!
+// The return value is false, if a communication error occured.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+int C_RV40F::ReadDataFrame(BYTE *buffer_p)
+{
+  WORD length;
+
+  if (false == ReceiveFrame(&m_comm_buffer[0], &length))
     return false;
+  memcpy(buffer_p, &m_comm_buffer[3], length);
 
-  return ret_value;
+  return true;
 }
 
-//Checks, if the data flash area contains data for programming.
-//Therefore it searches for 0x00 marked bytes in the appropriate DF_MARKER area.
-//Returns false, if area contains data.
+// Builds the sorted lists of image ranges with data (extents) from the MARKER areas (marker 0x00 = data):
+// CF: 1 marker byte per MIN_PAGE_SIZE bytes, DF: 1 marker byte per byte, extents in steps of m_DF_write_unit.
+// The option block is not included, it is handled separately.
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
-bool C_RV40F::DF_IsAreaEmpty(DWORD startAddress, DWORD areaSize)
+void C_RV40F::BuildExtents(void)
 {
-  DWORD addrCnt;
-  DWORD memAddress = startAddress + DF_MARKER_OFFSET;
-  bool ret_val = true;
+  delete[] m_CF_extent_p;
+  delete[] m_DF_extent_p;
+
+  //1st pass: count, 2nd pass: fill
+  m_CF_extent_cnt = ScanExtents(NULL, CF_MARKER_OFFSET, MIN_PAGE_SIZE, MIN_PAGE_SIZE, 0, m_DF_block_nr);
+  m_DF_extent_cnt = ScanExtents(NULL, DF_MARKER_OFFSET, 1, m_DF_write_unit, m_DF_block_nr, m_sector_quantity);
+  m_CF_extent_p = new EXTENT_T[m_CF_extent_cnt + 1];
+  m_DF_extent_p = new EXTENT_T[m_DF_extent_cnt + 1];
+  ScanExtents(m_CF_extent_p, CF_MARKER_OFFSET, MIN_PAGE_SIZE, MIN_PAGE_SIZE, 0, m_DF_block_nr);
+  ScanExtents(m_DF_extent_p, DF_MARKER_OFFSET, 1, m_DF_write_unit, m_DF_block_nr, m_sector_quantity);
+
+  delete[] m_CF_data_extent_p;
+  m_CF_data_extent_p = NULL;
+  m_CF_data_extent_cnt = 0;
+  if (m_fCF_skip0xFF)
+  {
+    m_CF_data_extent_cnt = ScanExtents(NULL, SCAN_NOT_0xFF, MIN_PAGE_SIZE, MIN_PAGE_SIZE, 0, m_DF_block_nr);
+    m_CF_data_extent_p = new EXTENT_T[m_CF_data_extent_cnt + 1];
+    ScanExtents(m_CF_data_extent_p, SCAN_NOT_0xFF, MIN_PAGE_SIZE, MIN_PAGE_SIZE, 0, m_DF_block_nr);
+  }
+
+#if (ALG_DEBUG > 1)
+  PRINTF("C_RV40F::BuildExtents() - CF: %d ranges, DF: %d ranges, CF != 0xFF: %d ranges\n", m_CF_extent_cnt, m_DF_extent_cnt, m_CF_data_extent_cnt);
+#endif
+}
 
-  for (addrCnt = 0; addrCnt < areaSize; addrCnt++)
+// Scans the markers (1 per markerUnit bytes) of the blocks firstBlock..lastBlock-1 in steps of unit bytes.
+// A unit contains data, if any of its markers is 0x00.
+// markerOffset == SCAN_NOT_0xFF: the units are checked for data != 0xFF instead.
+// Stores the ranges in list_p (if not NULL) and returns the count of ranges.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+DWORD C_RV40F::ScanExtents(EXTENT_T *list_p, const DWORD markerOffset, const DWORD markerUnit, const DWORD unit, const WORD firstBlock, const WORD lastBlock)
+{
+  DWORD cnt = 0;
+  DWORD address, endaddress, marker;
+  DWORD runStart = 0, runEnd = 0; //runStart == runEnd: no open range
+  WORD block;
+
+  for (block = firstBlock; block < lastBlock; block++)
   {
-    if (GetDataFromRam_8Bit(memAddress + addrCnt, (DWORD)m_srcdata_bp) == 0)
+    if (block == m_option_data_block)
+      continue;
+    endaddress = m_devsectors_p[block].end_address;
+    for (address = m_devsectors_p[block].begin_address; address <= endaddress; address += unit)
     {
-      ret_val = false;
-      break;
+      if (markerOffset == SCAN_NOT_0xFF)
+      {
+        if (MemScan_AllEqual(&m_srcdata_bp[address], unit, 0xFF))
+          continue; //erased state
+      }
+      else
+      {
+        for (marker = 0; marker < unit / markerUnit; marker++)
+        {
+          if (0 == GetDataFromRam_8Bit(markerOffset + address / markerUnit + marker, (DWORD)m_srcdata_bp))
+            break;
+        }
+        if (marker == unit / markerUnit)
+          continue; //no data
+      }
+      if (runEnd != runStart && address == runEnd)
+      {
+        runEnd += unit; //extend the open range
+        continue;
+      }
+      if (runEnd != runStart)
+      {
+        if (list_p)
+        {
+          list_p[cnt].start = runStart;
+          list_p[cnt].size = runEnd - runStart;
+        }
+        cnt++;
+      }
+      runStart = address;
+      runEnd = address + unit;
+    }
+  }
+  if (runEnd != runStart)
+  {
+    if (list_p)
+    {
+      list_p[cnt].start = runStart;
+      list_p[cnt].size = runEnd - runStart;
     }
+    cnt++;
   }
 
-  return ret_val;
+  return cnt;
 }
 
-//Checks, if the code flash area contains data for programming.
-//Returns false, if area contains data.
+// Returns the index of the first extent, which ends behind address (binary search).
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
-bool C_RV40F::CF_IsAreaEmpty(DWORD startAddress, DWORD areaSize)
+DWORD C_RV40F::FindExtent(const EXTENT_T *list_p, const DWORD cnt, const DWORD address)
 {
-  DWORD blockCnt;
-  DWORD blockSize = areaSize / MIN_PAGE_SIZE;
-  DWORD memAddress = startAddress / MIN_PAGE_SIZE + CF_MARKER_OFFSET;
-  bool ret_val = true;
+  DWORD low = 0, high = cnt, mid;
 
-  for (blockCnt = 0; blockCnt < blockSize; blockCnt++)
+  while (low < high)
   {
-    if (GetDataFromRam_8Bit(memAddress + blockCnt, (DWORD)m_srcdata_bp) == 0)
-    {
-      ret_val = false;
-      break;
-    }
+    mid = (low + high) / 2;
+    if (list_p[mid].start + list_p[mid].size <= address)
+      low = mid + 1;
+    else
+      high = mid;
   }
+  return low;
+}
 
-  return ret_val;
+//Checks, if the data flash area contains data for programming.
+//Returns false, if area contains data.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+bool C_RV40F::DF_IsAreaEmpty(DWORD startAddress, DWORD areaSize)
+{
+  DWORD ext = FindExtent(m_DF_extent_p, m_DF_extent_cnt, startAddress);
+
+  return (ext >= m_DF_extent_cnt || m_DF_extent_p[ext].start >= startAddress + areaSize);
+}
+
+//Checks, if the code flash area contains data for programming.
+//Returns false, if area contains data.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+bool C_RV40F::CF_IsAreaEmpty(DWORD startAddress, DWORD areaSize)
+{
+  DWORD ext = FindExtent(m_CF_extent_p, m_CF_extent_cnt, startAddress);
+
+  return (ext >= m_CF_extent_cnt || m_CF_extent_p[ext].start >= startAddress + areaSize);
 }
 
 //Checks, if the code flash area is filled up with data for programming.
@@ -1349,21 +2350,12 @@ bool C_RV40F::CF_IsAreaEmpty(DWORD startAddress, DWORD areaSize)
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 bool C_RV40F::CF_IsAreaFragmented(DWORD startAddress, DWORD areaSize)
 {
-  DWORD blockCnt;
-  DWORD blockSize = areaSize / MIN_PAGE_SIZE;
-  DWORD memAddress = startAddress / MIN_PAGE_SIZE + CF_MARKER_OFFSET;
-  bool ret_val = false;
-
-  for (blockCnt = 0; blockCnt < blockSize; blockCnt++)
-  {
-    if (GetDataFromRam_8Bit(memAddress + blockCnt, (DWORD)m_srcdata_bp))
-    {
-      ret_val = true;
-      break;
-    }
-  }
+  DWORD ext = FindExtent(m_CF_extent_p, m_CF_extent_cnt, startAddress);
 
-  return ret_val;
+  if (ext >= m_CF_extent_cnt)
+    return true;
+  return (m_CF_extent_p[ext].start > startAddress ||
+          m_CF_extent_p[ext].start + m_CF_extent_p[ext].size < startAddress + areaSize);
 }
 
 //check whether ICU_S area is empty - not allowed!
@@ -1383,28 +2375,338 @@ bool C_RV40F::CF_IsAreaFragmented(DWORD startAddress, DWORD areaSize)
   return area_included;
 }*/
 
+// Programs an image range with one PROGRAM command: the data is sent in ETB chained frames of MAX_PAGE_SIZE bytes,
+// the last frame is terminated with ETX.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+C_RV40F::DEV_STAT_E C_RV40F::ProgramRange(DWORD startInMem, DWORD startInDev, DWORD areaSize)
+{
+  volatile BYTE *srcbase = (volatile BYTE *)m_srcdata_bp;
+  DWORD offset;
+  WORD frameSize;
+  FRAMEEND_T frameEndType;
+
+  WriteCmdBuffer(PROGRAM_CMD, startInDev, startInDev + areaSize - 1);
+
+  if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
+    return WSM_BUSY_ERR;
+
+  if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
+    return PROGRAM_ERR;
+
+  for (offset = 0; offset < areaSize; offset += frameSize)
+  {
+    if (areaSize - offset > MAX_PAGE_SIZE)
+    {
+      frameSize = MAX_PAGE_SIZE;
+      frameEndType = ETB; //end of block
+    }
+    else
+    {
+      frameSize = (WORD)(areaSize - offset);
+      frameEndType = ETX; //end of all data
+    }
+
+    if (false == SendFrame(SOD, frameEndType, (BYTE *)(srcbase + startInMem + offset), frameSize, PROGRAM_CMD))
+      return WSM_BUSY_ERR;
+    if (frameEndType == ETB) //stage the next page while the device is busy
+      PreloadFrame(SOD, (BYTE *)(srcbase + startInMem + offset + frameSize),
+                   (areaSize - offset - frameSize > MAX_PAGE_SIZE) ? MAX_PAGE_SIZE : (WORD)(areaSize - offset - frameSize), PROGRAM_CMD);
+
+    if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
+    {
+      PRINTF("C_RV40F::Programming fail at 0x%X\n", startInDev + offset);
+      return PROGRAM_ERR;
+    }
+  }
+
+  return OPERATION_OK;
+}
+
+// Programs the extents of list_p clipped to startaddress..endaddress (one PROGRAM command per extent).
+// Data flash extents (m_DF_extent_p) are re-mapped to the device addresses.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+C_RV40F::DEV_STAT_E C_RV40F::ProgramExtents(const EXTENT_T *list_p, const DWORD cnt, DWORD startaddress, DWORD endaddress)
+{
+  DEV_STAT_E prog_stat = OPERATION_OK;
+  DWORD rangeStart, rangeEnd;
+  DWORD ext;
+
+  for (ext = FindExtent(list_p, cnt, startaddress);
+       ext < cnt && list_p[ext].start <= endaddress && prog_stat == OPERATION_OK;
+       ext++)
+  {
+    rangeStart = (list_p[ext].start > startaddress) ? list_p[ext].start : startaddress;
+    rangeEnd = list_p[ext].start + list_p[ext].size - 1;
+    if (rangeEnd > endaddress)
+      rangeEnd = endaddress;
+
+    if (list_p == m_DF_extent_p)
+      prog_stat = ProgramRange(rangeStart, GetDFAdressInDevice(rangeStart), rangeEnd - rangeStart + 1);
+    else
+      prog_stat = ProgramRange(rangeStart, rangeStart, rangeEnd - rangeStart + 1);
+  }
+
+  return prog_stat;
+}
+
+// Verifies an image range by reading it back: the device returns the data in frames of MAX_PAGE_SIZE bytes,
+// each one requested with a reverse ACK.
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 C_RV40F::DEV_STAT_E C_RV40F::VerifyArea(DWORD startInMem, DWORD startInDev, DWORD areaSize)
 {
   volatile BYTE *srcbase = (volatile BYTE *)m_srcdata_bp;
+  DWORD offset;
+  WORD frameSize;
 
   WriteCmdBuffer(READ_CMD, startInDev, startInDev + areaSize - 1);
   if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
     return VERIFY_ERR;
   if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
     return VERIFY_ERR;
+
+  for (offset = 0; offset < areaSize; offset += frameSize)
+  {
+    frameSize = (areaSize - offset > MAX_PAGE_SIZE) ? MAX_PAGE_SIZE : (WORD)(areaSize - offset);
+
+    if (false == SendFrame(SOD, ETX, GetCmdBufferP(), 1)) //reverse ACK
+      return VERIFY_ERR;
+
+    if (false == GetDataFrame((offset + frameSize < areaSize) ? ETB : ETX, (BYTE *)(srcbase + startInMem + offset), frameSize, frameSize, READ_CMD))
+    {
+      PRINTF("C_RV40F::Verify fail at address 0x%X\n", startInMem + offset);
+      return VERIFY_ERR;
+    }
+  }
+
+  return OPERATION_OK;
+}
+
+// HYBRID_VERIFY, 1st step: CRC check of a code flash block. The sockets with CRC mismatch are returned in *fail_p,
+// they stay enabled until LocalizeCRCFail() found the failing pages.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+C_RV40F::DEV_STAT_E C_RV40F::CheckSectorCRC(const WORD block, SOCKET_STATUS_T *fail_p)
+{
+  DWORD checkSum; //CRC32
+  BYTE data_buffer[4];
+
+  m_current_CMD = CRC_CMD;
+  WriteCmdBuffer(CRC_CMD, m_devsectors_p[block].begin_address, m_devsectors_p[block].end_address);
+
+  if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
+    return WSM_BUSY_ERR;
+  if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
+    return VERIFY_ERR;
   if (false == SendFrame(SOD, ETX, GetCmdBufferP(), 1)) //reverse ACK
     return VERIFY_ERR;
 
-  if (false == GetDataFrame(ETX, (BYTE *)(srcbase + startInMem), (WORD)areaSize, (WORD)areaSize, READ_CMD))
+  checkSum = GetSectorCRC(block);
+  data_buffer[0] = (BYTE)(checkSum >> 24);
+  data_buffer[1] = (BYTE)(checkSum >> 16);
+  data_buffer[2] = (BYTE)(checkSum >> 8);
+  data_buffer[3] = (BYTE)(checkSum >> 0);
+  *fail_p = CompareDataFrame(ETX, data_buffer, 4, 4, CRC_CMD);
+  if (CompareFailed(*fail_p))
+    PRINTF("C_RV40F::CRC check failed in block %d, sockets %Xh\n", block, (WORD)*fail_p);
+
+  return OPERATION_OK;
+}
+
+// HYBRID_VERIFY, 2nd step: verifies a block with CRC mismatch page by page (one VERIFY command per page)
+// and logs the failing pages. The sockets in failMask are disabled afterwards.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+C_RV40F::DEV_STAT_E C_RV40F::LocalizeCRCFail(const WORD block, const SOCKET_STATUS_T failMask)
+{
+  volatile BYTE *srcbase = (volatile BYTE *)m_srcdata_bp;
+  DWORD address, endaddress;
+  DWORD firstFailAddress = m_devsectors_p[block].begin_address;
+  WORD pageSize;
+  WORD failedPages = 0;
+  SOCKET_STATUS_T page_stat;
+
+  endaddress = m_devsectors_p[block].end_address;
+  m_current_CMD = VERIFY_CMD;
+  for (address = m_devsectors_p[block].begin_address; address <= endaddress; address += pageSize)
+  {
+    pageSize = (endaddress - address + 1 > MAX_PAGE_SIZE) ? MAX_PAGE_SIZE : (WORD)(endaddress - address + 1);
+
+    WriteCmdBuffer(VERIFY_CMD, address, address + pageSize - 1);
+    if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
+      return WSM_BUSY_ERR;
+    if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
+      return VERIFY_ERR;
+    if (false == SendFrame(SOD, ETX, (BYTE *)(srcbase + address), pageSize, VERIFY_CMD))
+      return WSM_BUSY_ERR;
+
+    page_stat = CompareDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1) & failMask;
+    if (CompareFailed(page_stat))
+    {
+      if (failedPages == 0)
+        firstFailAddress = address;
+      if (failedPages < HYBRID_LOG_PAGES)
+      {
+        sprintf(msgbuff, "Verify error in block %d at 0x%08X..0x%08X, sockets %Xh", block, address, address + pageSize - 1, (WORD)page_stat);
+        m_prg_api_p->Write2EventLog(msgbuff);
+      }
+      failedPages++;
+    }
+  }
+  if (failedPages > HYBRID_LOG_PAGES)
   {
-    PRINTF("C_RV40F::Verify fail at address 0x%X\n", startInMem);
+    sprintf(msgbuff, "Verify error in block %d: %d pages failed.", block, failedPages);
+    m_prg_api_p->Write2EventLog(msgbuff);
+  }
+
+  //the CRC mismatch is the verify result, even if no page failed
+  if (!m_prg_api_p->MisCompare(m_current_op_mode, failMask, firstFailAddress, 0))
     return VERIFY_ERR;
+
+  return OPERATION_OK;
+}
+
+// Incremental programming: compares the CRC of each CF block to be erased and programmed with the image CRC.
+// A block is marked as unchanged (m_block_unchanged_p), if the CRC matches on all sockets.
+// Only blocks, which are completely defined by the image (fill-up mode or no gaps), are checked.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+C_RV40F::DEV_STAT_E C_RV40F::FindUnchangedBlocks(void)
+{
+  DEV_STAT_E stat;
+  SOCKET_STATUS_T fail_stat;
+  WORD block, checked = 0, unchanged = 0;
+  DWORD blockSize;
+
+  memset(m_block_unchanged_p, false, m_sector_quantity * sizeof(bool));
+  m_fUnchangedValid = false;
+
+  for (block = 0; block < m_DF_block_nr; block++)
+  {
+    if (block == m_option_data_block)
+      continue;
+    if (!m_prg_api_p->GetSectorFlag(SectorOp::ERASE_SECTOR_OP, block) ||
+        !m_prg_api_p->GetSectorFlag(SectorOp::PROGRAM_SECTOR_OP, block))
+      continue;
+    blockSize = m_devsectors_p[block].end_address - m_devsectors_p[block].begin_address + 1;
+    if (m_fCF_filled0xFF == false && CF_IsAreaFragmented(m_devsectors_p[block].begin_address, blockSize))
+      continue; //image does not define the complete block
+
+    stat = CheckSectorCRC(block, &fail_stat);
+    if (stat != OPERATION_OK)
+      return stat;
+    checked++;
+    if (ComparePassed(fail_stat))
+    {
+      m_block_unchanged_p[block] = true;
+      unchanged++;
+    }
+
+    // check for any system events
+    if (m_prg_api_p->SysEvtChk())
+      return HARDWARE_ERR; // O.C. or Adapter change - return immediately
   }
 
+  sprintf(msgbuff, "Incremental programming: %d of %d blocks unchanged, skipped.", unchanged, checked);
+  m_prg_api_p->Write2EventLog(msgbuff);
+  m_fUnchangedValid = true; //valid for the current part only
+
   return OPERATION_OK;
 }
 
+// Erases startaddress_in_device..endaddress_in_device with one ERASE command (range erase).
+// A device may ignore the end address and erase the first block only: a passed range erase is confirmed
+// with one BLANKCHECK command over the same range.
+// The failing sockets are not disabled: the return value is false, if any socket failed or rejected a command.
+// Then the caller erases the range block by block.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+bool C_RV40F::TryRangeErase(const DWORD startaddress_in_device, const DWORD endaddress_in_device)
+{
+  SOCKET_STATUS_T fail_stat;
+
+  m_current_CMD = ERASE_CMD;
+  WriteCmdBuffer(ERASE_CMD, startaddress_in_device, endaddress_in_device);
+
+  if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
+    return false;
+
+  fail_stat = CompareDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1, 0, ERASE_TIMEOUT_MS);
+  if (ComparePassed(fail_stat))
+  { //confirm the range erase
+    m_current_CMD = BLANKCHECK_CMD;
+    WriteCmdBuffer(BLANKCHECK_CMD, startaddress_in_device, endaddress_in_device);
+
+    if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
+      return false;
+
+    fail_stat = CompareDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1, 0, ERASE_TIMEOUT_MS);
+  }
+  if (CompareFailed(fail_stat))
+  {
+    PRINTF("C_RV40F::TryRangeErase() - range %08Xh..%08Xh failed (cmd %Xh, sockets %Xh), erasing block by block\n",
+           startaddress_in_device, endaddress_in_device, (WORD)m_current_CMD, (WORD)fail_stat);
+    return false;
+  }
+
+  return true;
+}
+
+// Erases the selected code flash blocks 0..blockCount-1 (without option block and data flash).
+// Contiguous blocks are grouped to one range erase (m_fRangeErase), otherwise each block gets its own ERASE command.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+C_RV40F::DEV_STAT_E C_RV40F::EraseCFBlocks(const WORD blockCount)
+{
+  DEV_STAT_E erase_stat = OPERATION_OK;
+  WORD block, first, last;
+  DWORD start_ms;
+
+  block = 0;
+  while (block < blockCount && erase_stat == OPERATION_OK)
+  {
+    // see if block has to be erased
+    if (!m_prg_api_p->GetSectorFlag(SectorOp::ERASE_SECTOR_OP, block) ||
+        block == m_option_data_block || block >= m_DF_block_nr || m_block_unchanged_p[block])
+    {
+      block++;
+      continue;
+    }
+
+    //group the following blocks to be erased, which are contiguous in the device
+    first = block;
+    last = block;
+    while (m_fRangeErase && last + 1 < blockCount &&
+           m_prg_api_p->GetSectorFlag(SectorOp::ERASE_SECTOR_OP, last + 1) &&
+           last + 1 != m_option_data_block && last + 1 < m_DF_block_nr && !m_block_unchanged_p[last + 1] &&
+           m_devsectors_p[last + 1].begin_address == m_devsectors_p[last].end_address + 1)
+      last++;
+    block = last + 1;
+    start_ms = GetTimeMs();
+    m_erase_blocks += last - first + 1;
+
+    if (last > first && TryRangeErase(m_devsectors_p[first].begin_address, m_devsectors_p[last].end_address))
+      m_erase_cmds_saved += last - first;
+    else
+    {
+      for (; first <= last && erase_stat == OPERATION_OK; first++)
+      {
+        WriteCmdBuffer(ERASE_CMD, m_devsectors_p[first].begin_address, 0);
+
+        if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 5))
+          return WSM_BUSY_ERR;
+
+        if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
+        {
+          erase_stat = BLOCK_ERASE_ERR;
+          PRINTF("C_RV40F::Erasing failed in block %d\n", first);
+        }
+      }
+    }
+    m_erase_ms += GetTimeMs() - start_ms;
+
+    // check for any system events
+    if (m_prg_api_p->SysEvtChk())
+      return HARDWARE_ERR; // O.C. or Adapter change - return immediately
+  }
+
+  return erase_stat;
+}
+
 // Verify DATA FLASH data received serially via SO against data in buffer_p when the data is marked in buffer_p + DF_MARKER_OFFSET
 // The return value is false, if an error occured and all sockets are wrong.
 // It does not matter which part of the frame failed, the appropriated socket is switched off.
@@ -1413,15 +2715,10 @@ int C_RV40F::VerifyDFblock(const FRAMEEND_T endType, BYTE *buffer_p, WORD pageSZ
 {
   int ret_value = true;
   SOCKET_STATUS_T socket_stat;
-  BYTE expectedData;
-  DWORD bytecnt;
-  DWORD ulMaxRetries = DEFAULT_TIMEOUT;
+  WORD frameLength;
 
   //synchronize with uC
-  do
-  {
-    socket_stat = m_fpga_p->ParDataCompare(LOGIC_1, 0xFFFE); //D0 = SO
-  } while (ulMaxRetries-- && socket_stat);
+  socket_stat = WaitUntilDeviceReady(m_current_op_mode, LOGIC_1, DEFAULT_TIMEOUT_MS);
 
   if (CompareFailed(socket_stat))
   {
@@ -1432,73 +2729,66 @@ int C_RV40F::VerifyDFblock(const FRAMEEND_T endType, BYTE *buffer_p, WORD pageSZ
     }
   }
 
-  // Frame Header
-  expectedData = SOD;
-  socket_stat = m_fpga_p->SerialCompare(&expectedData, &COMPARE_ALL_MASK, 8);
-  if (CompareFailed(socket_stat))
-  {
-    PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. SOD not recognized.\n", (WORD)m_current_CMD);
-    if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, expectedData))
-      return false;
-  }
+  // Expected frame: SOD + LN + READ_CMD + data + CS + end of frame
+  frameLength = BuildFrame(SOD, endType, buffer_p, pageSZ, READ_CMD);
+  memset(&m_cmp_mask[0], COMPARE_ALL_MASK, frameLength);
+  if (false == m_fDF_filled0xFF)
+    memcpy(&m_cmp_mask[4], &buffer_p[DF_MARKER_OFFSET], pageSZ); //check marked data only
+  m_cmp_mask[frameLength - 2] = COMPARE_NOTHING; //checksum: ignore it
 
-  expectedData = HIBYTE(pageSZ + 1);
-  socket_stat = m_fpga_p->SerialCompare(&expectedData, &COMPARE_ALL_MASK, 8);
+  socket_stat = CompareFrame(frameLength);
   if (CompareFailed(socket_stat))
   {
-    PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Unexpected frame length.\n", (WORD)m_current_CMD);
-    if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, expectedData))
+    PRINTF("C_RV40F::VerifyDFblock() - Check status for command %Xh failed. Unexpected data in DF.\n", (WORD)m_current_CMD);
+    if (!MisCompareFrame(socket_stat, (DWORD)buffer_p - (DWORD)m_srcdata_bp, 4)) //address: image address
       return false;
   }
 
-  expectedData = LOBYTE(pageSZ + 1);
-  socket_stat = m_fpga_p->SerialCompare(&expectedData, &COMPARE_ALL_MASK, 8);
-  if (CompareFailed(socket_stat))
-  {
-    PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Unexpected frame length.\n", (WORD)m_current_CMD);
-    if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, expectedData))
-      return false;
-  }
+  return ret_value;
+}
 
-  socket_stat = m_fpga_p->SerialCompare(&READ_CMD, &COMPARE_ALL_MASK, 8);
-  if (CompareFailed(socket_stat))
-  {
-    PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Unexpected ACK code.\n", (WORD)m_current_CMD);
-    if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, READ_CMD))
-      return false;
-  }
+// Starts an operation in the current session. The target is only (re-)initialized, if it is not in session.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+bool C_RV40F::BeginOperation(const DEV_OP_E opMode)
+{
+  m_current_op_mode = opMode;
+  m_session.operations++;
+  if (m_fTarget_initialized)
+    m_session.inits_skipped++;
+
+  return DeviceInit();
+}
+
+// After an error: checks with one gang INQUIRY, if all sockets are still in session (command level synchronized).
+// Only if a socket does not answer, all sockets are reset to programming mode and re-initialized by the next operation.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void C_RV40F::RecoverSession(void)
+{
+  BYTE ack = INQUIRY_CMD;
 
-  // DATA
-  for (bytecnt = 0; bytecnt < pageSZ; bytecnt++)
+  m_current_CMD = INQUIRY_CMD;
+  if (m_fTarget_initialized && (m_current_op_mode != DeviceOperation::READ) &&
+      SendFrame(SOH, ETX, &ack, 1) && ComparePassed(CompareDataFrame(ETX, &ack, CHECK_ST1, CHECK_ST1)))
   {
-    if (false == m_fDF_filled0xFF)
-      socket_stat = m_fpga_p->SerialCompare(&buffer_p[bytecnt], &buffer_p[bytecnt + DF_MARKER_OFFSET], 8); //check marked data only
-    else
-      socket_stat = m_fpga_p->SerialCompare(&buffer_p[bytecnt], &COMPARE_ALL_MASK, 8);
-
-    if (CompareFailed(socket_stat))
-    {
-      PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Unexpected data in DF.\n", (WORD)m_current_CMD);
-      if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0xDDDD, expectedData))
-        return false;
-    }
+    m_session.recoveries++;
+    return;
   }
 
-  // Check sum
-  expectedData = 0x00; //ignore it
-  m_fpga_p->SerialCompare(&expectedData, &COMPARE_NOTHING, 8);
+  PRINTF("C_RV40F::RecoverSession() - session lost, reset to programming mode\n");
+  ResetToProgrammingMode();
+}
 
-  // End of frame
-  expectedData = endType;
-  socket_stat = m_fpga_p->SerialCompare(&expectedData, &COMPARE_ALL_MASK, 8);
-  if (CompareFailed(socket_stat))
+// Logs the session statistics and clears them.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void C_RV40F::ReportSession(void)
+{
+  if (m_session.operations)
   {
-    PRINTF("C_RV40F::GetDataFrame() - Check status for command %Xh failed. Frame end mark not recognized.\n", (WORD)m_current_CMD);
-    if (!m_prg_api_p->MisCompare(m_current_op_mode, socket_stat, 0, expectedData))
-      return false;
+    sprintf(msgbuff, "Session: %d operations, %d re-syncs avoided by error recovery, %d mode entries (target already initialized: %d).",
+            m_session.operations, m_session.recoveries, m_session.mode_entries, m_session.inits_skipped);
+    m_prg_api_p->Write2EventLog(msgbuff);
   }
-
-  return ret_value;
+  memset(&m_session, 0, sizeof(m_session));
 }
 
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
@@ -1517,6 +2807,7 @@ bool C_RV40F::DeviceInit(void)
   BYTE expectedICUSmode = UNKNOWN;
   bool device_init_ok = true;
   SOCKET_STATUS_T socket_stat = 0;
+  SOCKET_STATUS_T readback_mask;
 
   if (m_fTarget_initialized)
     return true; //device already up and running (programming mode activated, frequency set and eventually new bootloader loaded)
@@ -1550,15 +2841,24 @@ bool C_RV40F::DeviceInit(void)
   m_fReadProtected = false;
   m_optionSupportedByDev &= ~(DWORD)ID_AUTH; //set it to initial value. it depends on the device settings
 
+  //gang mode: compare the device type of all sockets at once, only failing sockets are read back (diagnostics)
+  WORD socket_mask = LM_Phapi::Get()->ActiveDUTMaskGet();
+  if (m_current_op_mode != DeviceOperation::READ)
+  {
+    memcpy(data_buffer, m_tRV40F_Param_p->TYPE, DEVTYPE_LENGTH);
+    readback_mask = GangCompareCmd(DEVICE_TYPE_GET_CMD, data_buffer, DEVTYPE_LENGTH, 8); //frequencies are not checked
+  }
+  else
+    readback_mask = (SOCKET_STATUS_T)socket_mask;
+
   //Collect data socket by socket
   failed_skt_mask = 0;
-  WORD socket_mask = LM_Phapi::Get()->ActiveDUTMaskGet();
   m_current_op_mode = DeviceOperation::READ;
   for (nDUT = MAX_SOCKET_NUM - 1; nDUT >= 0; nDUT--)
   {
-    // check only active sockets
+    // check only active sockets, which failed the gang compare
     skt_stat = m_prg_api_p->SocketStatusGet(SocketNumChange(nDUT + 1));
-    if (skt_stat == SOCKET_ENABLE)
+    if (skt_stat == SOCKET_ENABLE && (readback_mask & (1 << nDUT)))
     {
       // activate this one socket for reading
       // Note: ALL OTHER SOCKETS WILL BE DISABLED
@@ -1895,7 +3195,10 @@ bool C_RV40F::DeviceInit(void)
     PRINTF(" OC @ line %d\n", __LINE__);
 
   if (device_init_ok)
+  {
     m_fTarget_initialized = true;
+    m_fGangInitialized = (saved_current_op_mode != DeviceOperation::READ); //READ: only the read socket was checked
+  }
 
   return device_init_ok;
 }
@@ -2173,6 +3476,7 @@ C_RV40F::DEV_STAT_E C_RV40F::Erase_DataFlash_Area(DWORD DF_startaddress_in_devic
   DWORD data_area_size;
 
   DWORD address, startaddress_in_device;
+  DWORD start_ms = GetTimeMs();
   bool fResetReq = false;
 
   DEV_STAT_E erase_stat = OPERATION_OK;
@@ -2180,6 +3484,15 @@ C_RV40F::DEV_STAT_E C_RV40F::Erase_DataFlash_Area(DWORD DF_startaddress_in_devic
   //DF_startaddress_in_device = GetDFAdressInDevice(m_devsectors_p[block].begin_address);
   //erase data flash area (RV40F flash)
   data_area_size = (DF_endaddress_in_device - DF_startaddress_in_device) + 1;
+  m_erase_blocks += (WORD)(data_area_size / m_DF_erase_unit);
+
+  if (m_fRangeErase && data_area_size > m_DF_erase_unit &&
+      TryRangeErase(DF_startaddress_in_device, DF_endaddress_in_device))
+  {
+    m_erase_cmds_saved += (WORD)(data_area_size / m_DF_erase_unit - 1);
+    m_erase_ms += GetTimeMs() - start_ms;
+    return OPERATION_OK;
+  }
 
   for (address = 0; address < data_area_size && erase_stat == OPERATION_OK; address += m_DF_erase_unit)
   {
@@ -2196,6 +3509,7 @@ C_RV40F::DEV_STAT_E C_RV40F::Erase_DataFlash_Area(DWORD DF_startaddress_in_devic
       PRINTF("C_RV40F::Erasing failed at data flash address %08Xh\n", startaddress_in_device);
     }
   } //-- OF for (address = 0; address < ; address += )
+  m_erase_ms += GetTimeMs() - start_ms;
   return erase_stat;
 }
 
@@ -2239,43 +3553,10 @@ C_RV40F::DEV_STAT_E C_RV40F::Program_DataFlash_Area(WORD block, WORD ICU_S_Regio
   address = m_devsectors_p[block].begin_address;
   endaddress = m_devsectors_p[block].end_address - ICU_S_RegionSize;
   if (m_fDF_filled0xFF == false)
-  {
-    do
-    {
-      //search for words to be programmed (marked with 0x00 in the MARKER area)
-      while (DF_IsAreaEmpty(address, m_DF_write_unit) && address <= endaddress)
-        address += m_DF_write_unit;
-      if (address > endaddress)
-        break; //reached end of DF sector
-      startaddress = address;
-      do
-      {
-        address += m_DF_write_unit;
-        if (0 == (address % MAX_PAGE_SIZE))
-          break;
-      } while (!DF_IsAreaEmpty(address, m_DF_write_unit));
-
-      startaddress_in_device = GetDFAdressInDevice(startaddress);
-      endaddress_in_device = GetDFAdressInDevice(address - 1);
-      areaSize = (WORD)(endaddress_in_device - startaddress_in_device + 1);
-
-      WriteCmdBuffer(PROGRAM_CMD, startaddress_in_device, endaddress_in_device);
-
-      if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
-        return WSM_BUSY_ERR;
-
-      if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
-        return PROGRAM_ERR;
-
-      if (false == SendFrame(SOD, ETX, (BYTE *)(srcbase + startaddress), areaSize, PROGRAM_CMD))
-        return WSM_BUSY_ERR;
-
-      if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
-      {
-        prog_stat = PROGRAM_ERR;
-        PRINTF("C_RV40F::Programming fail at DF address 0x%X\n", startaddress);
-      }
-    } while (address <= endaddress && prog_stat == OPERATION_OK);
+  { //only the write units marked with 0x00 in the MARKER area: one PROGRAM command per extent
+    prog_stat = ProgramExtents(m_DF_extent_p, m_DF_extent_cnt, address, endaddress);
+    if (prog_stat == PROGRAM_ERR)
+      PRINTF("C_RV40F::Programming fail in DF block %d\n", block);
   } // OF if(m_fDF_filled0xFF == false)
   else
   {
@@ -2307,6 +3588,8 @@ C_RV40F::DEV_STAT_E C_RV40F::Program_DataFlash_Area(WORD block, WORD ICU_S_Regio
 
       if (false == SendFrame(SOD, frameEndType, (BYTE *)(srcbase + address), blockSize, PROGRAM_CMD))
         return WSM_BUSY_ERR;
+      if (frameEndType == ETB) //stage the next page while the device is busy
+        PreloadFrame(SOD, (BYTE *)(srcbase + address + blockSize), blockSize, PROGRAM_CMD);
       if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
       {
         prog_stat = PROGRAM_ERR;
@@ -2320,26 +3603,50 @@ C_RV40F::DEV_STAT_E C_RV40F::Program_DataFlash_Area(WORD block, WORD ICU_S_Regio
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 C_RV40F::DEV_STAT_E C_RV40F::Verify_DataFlash_Area(WORD block, WORD ICU_S_RegionSize)
 {
+  DWORD startaddress, endaddress;
+  DWORD rangeStart, rangeEnd;
+  DWORD ext;
+  DEV_STAT_E verify_stat = OPERATION_OK;
+
+  startaddress = m_devsectors_p[block].begin_address;
+  endaddress = m_devsectors_p[block].end_address - ICU_S_RegionSize;
+
+  if (m_fDF_filled0xFF)
+    return VerifyDFRange(startaddress, endaddress);
+
+  //only the extents, which are programmed (same list as in Program_DataFlash_Area).
+  //Extents with a gap shorter than one frame are read with one READ command: the marker mask skips the gap bytes.
+  ext = FindExtent(m_DF_extent_p, m_DF_extent_cnt, startaddress);
+  while (ext < m_DF_extent_cnt && m_DF_extent_p[ext].start <= endaddress && verify_stat == OPERATION_OK)
+  {
+    rangeStart = (m_DF_extent_p[ext].start > startaddress) ? m_DF_extent_p[ext].start : startaddress;
+    rangeEnd = m_DF_extent_p[ext].start + m_DF_extent_p[ext].size - 1;
+    for (ext++; ext < m_DF_extent_cnt && m_DF_extent_p[ext].start <= endaddress &&
+                m_DF_extent_p[ext].start - rangeEnd - 1 < MAX_PAGE_SIZE;
+         ext++)
+      rangeEnd = m_DF_extent_p[ext].start + m_DF_extent_p[ext].size - 1;
+    if (rangeEnd > endaddress)
+      rangeEnd = endaddress;
+
+    verify_stat = VerifyDFRange(rangeStart, rangeEnd);
+  }
+
+  return verify_stat;
+}
 
+// Verifies the data flash range startaddress..endaddress (image addresses) with one READ command.
+// The data is compared frame by frame (VerifyDFblock).
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+C_RV40F::DEV_STAT_E C_RV40F::VerifyDFRange(DWORD startaddress, DWORD endaddress)
+{
   volatile BYTE *srcbase = (volatile BYTE *)m_srcdata_bp;
-  DWORD startaddress, endaddress;
   DWORD startaddress_in_device, endaddress_in_device;
   DWORD address;
   WORD blockSize;
-  DWORD areaSize;
   BYTE frameEndType;
-  DEV_STAT_E verify_stat = OPERATION_OK;
 
-  startaddress = m_devsectors_p[block].begin_address;
-  endaddress = m_devsectors_p[block].end_address - ICU_S_RegionSize;
   startaddress_in_device = GetDFAdressInDevice(startaddress);
   endaddress_in_device = GetDFAdressInDevice(endaddress);
-  areaSize = endaddress_in_device - startaddress_in_device + 1;
-
-  if (areaSize < MAX_PAGE_SIZE)
-    blockSize = (WORD)areaSize;
-  else
-    blockSize = MAX_PAGE_SIZE;
 
   //use read command here, because CRC and VERIFY commands request at least 1024byte blocks
   WriteCmdBuffer(READ_CMD, startaddress_in_device, endaddress_in_device);
@@ -2349,23 +3656,27 @@ C_RV40F::DEV_STAT_E C_RV40F::Verify_DataFlash_Area(WORD block, WORD ICU_S_Region
   if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
     return VERIFY_ERR;
 
-  for (address = startaddress;
-       address <= endaddress && verify_stat == OPERATION_OK;
-       address += blockSize)
+  for (address = startaddress; address <= endaddress; address += blockSize)
   {
     if (false == SendFrame(SOD, ETX, GetCmdBufferP(), 1)) //reverse ACK
       return VERIFY_ERR;
 
-    if (address + blockSize > endaddress) //last data block?
-      frameEndType = ETX;                 //end of all data
-    else
+    if (endaddress - address + 1 > MAX_PAGE_SIZE)
+    {
+      blockSize = MAX_PAGE_SIZE;
       frameEndType = ETB; //end of block
+    }
+    else
+    {
+      blockSize = (WORD)(endaddress - address + 1);
+      frameEndType = ETX; //end of all data
+    }
 
     if (false == VerifyDFblock(frameEndType, (BYTE *)(srcbase + address), blockSize))
       return VERIFY_ERR;
   }
 
-  return verify_stat;
+  return OPERATION_OK;
 }
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
 int C_RV40F::CheckFlashID(void)
@@ -2396,20 +3707,24 @@ bool C_RV40F::IDCheck()
   BYTE stat_buffer[1];
   SOCKET_STATUS_E skt_stat;
   BYTE bytecnt, skt_mask, failed_skt_mask;
+  SOCKET_STATUS_T readback_mask;
   int nDUT;
   bool device_id_ok = true;
 
-  m_current_op_mode = DeviceOperation::IDCHECK;
-
-  if (false == DeviceInit())
+  if (false == BeginOperation(DeviceOperation::IDCHECK))
   {
     m_reset_H_flmd0_pulse_start_wait = 0; //re-start RST_H_FLMD0_DLY-pulse search in RESET
+    m_cached_mode_entry_wait = 0;         //without the cached delay
     return false;
   }
 
   failed_skt_mask = 0;
   // Get the status of all sockets (needed to re-enable sockets)
   WORD socket_mask = LM_Phapi::Get()->ActiveDUTMaskGet();
+
+  //gang mode: compare the signature of all sockets at once, only failing sockets are read back (diagnostics)
+  memcpy(data_buffer, m_tRV40F_Param_p->SIGNATURE, SIGNATURE_LENGTH);
+  readback_mask = GangCompareCmd(SIGNATURE_GET_CMD, data_buffer, m_signature_len, m_signature_len);
   m_current_op_mode = DeviceOperation::READ;
 
   for (nDUT = MAX_SOCKET_NUM - 1; nDUT >= 0; nDUT--)
@@ -2419,32 +3734,37 @@ bool C_RV40F::IDCheck()
     skt_stat = m_prg_api_p->SocketStatusGet(SocketNumChange(nDUT + 1));
     if (skt_stat == SOCKET_ENABLE)
     {
-      // active this one socket for reading
-      // Note: AL OTHER SOCKETS WILL BE DISABLED
       skt_mask = 1 << nDUT;
-      LM_Phapi::Get()->SetSingleSktMode((WORD)(nDUT + 1));
-
-      if (false == SendFrame(SOH, ETX, &SIGNATURE_GET_CMD, 1))
-        failed_skt_mask |= skt_mask;
-      if (false == GetDataFrame(ETX, stat_buffer, CHECK_ST1, CHECK_ST1))
-        failed_skt_mask |= skt_mask;
-      if (stat_buffer[0] != SIGNATURE_GET_CMD)
+      if (readback_mask & skt_mask)
       {
-        // disable the DUT
-        if (!m_prg_api_p->MisCompare(DeviceOperation::IDCHECK, skt_mask, 0, SIGNATURE_GET_CMD))
+        // active this one socket for reading
+        // Note: AL OTHER SOCKETS WILL BE DISABLED
+        LM_Phapi::Get()->SetSingleSktMode((WORD)(nDUT + 1));
+
+        if (false == SendFrame(SOH, ETX, &SIGNATURE_GET_CMD, 1))
           failed_skt_mask |= skt_mask;
-      }
+        if (false == GetDataFrame(ETX, stat_buffer, CHECK_ST1, CHECK_ST1))
+          failed_skt_mask |= skt_mask;
+        if (stat_buffer[0] != SIGNATURE_GET_CMD)
+        {
+          // disable the DUT
+          if (!m_prg_api_p->MisCompare(DeviceOperation::IDCHECK, skt_mask, 0, SIGNATURE_GET_CMD))
+            failed_skt_mask |= skt_mask;
+        }
 
-      if (failed_skt_mask & skt_mask)
-        continue;
+        if (failed_skt_mask & skt_mask)
+          continue;
 
-      if (false == SendFrame(SOD, ETX, stat_buffer, 1)) //reverse ACK
-        failed_skt_mask |= skt_mask;
-      if (false == GetDataFrame(ETX, data_buffer, m_signature_len, m_signature_len, SIGNATURE_GET_CMD))
-        failed_skt_mask |= skt_mask;
+        if (false == SendFrame(SOD, ETX, stat_buffer, 1)) //reverse ACK
+          failed_skt_mask |= skt_mask;
+        if (false == GetDataFrame(ETX, data_buffer, m_signature_len, m_signature_len, SIGNATURE_GET_CMD))
+          failed_skt_mask |= skt_mask;
 
-      if (failed_skt_mask & skt_mask)
-        continue;
+        if (failed_skt_mask & skt_mask)
+          continue;
+      }
+      else //signature already matched in gang mode
+        memcpy(data_buffer, m_tRV40F_Param_p->SIGNATURE, SIGNATURE_LENGTH);
 
       for (bytecnt = 0; bytecnt < DEVICE_NAME_LENGTH; bytecnt++) //device name
         dev_name[bytecnt] = data_buffer[bytecnt];
@@ -2473,6 +3793,8 @@ bool C_RV40F::IDCheck()
 
       if ((m_optionSupportedByDev & ID_AUTH) == 0)
       { //command protection mode
+        if (!(readback_mask & skt_mask))
+          LM_Phapi::Get()->SetSingleSktMode((WORD)(nDUT + 1));
         //check protection status
         m_current_CMD = PROTECTION_GET_CMD;
         if (false == SendFrame(SOH, ETX, &PROTECTION_GET_CMD, 1))
@@ -2521,12 +3843,32 @@ bool C_RV40F::IDCheck()
   {
     device_id_ok = false;
     m_reset_H_flmd0_pulse_start_wait = 0; //re-start RST_H_FLMD0_DLY-pulse search in RESET
+    m_cached_mode_entry_wait = 0;         //without the cached delay
   }
 
   //LM_Phapi::Get()->ScopePinSet (0);
   return device_id_ok;
 }
 
+// Sends BLANKCHECK_CMD for the blocks first..last (same flash area, contiguous). Data flash: without ICU-S region.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+bool C_RV40F::SendBlankCheckCmd(const WORD first, const WORD last)
+{
+  DWORD startaddress_in_device = m_devsectors_p[first].begin_address;
+  DWORD endaddress_in_device = m_devsectors_p[last].end_address;
+
+  if (first >= m_DF_block_nr)
+  {
+    startaddress_in_device = GetDFAdressInDevice(startaddress_in_device);
+    endaddress_in_device = GetDFAdressInDevice(endaddress_in_device - m_ICU_S_RegionSize);
+  }
+
+  m_current_CMD = BLANKCHECK_CMD;
+  WriteCmdBuffer(BLANKCHECK_CMD, startaddress_in_device, endaddress_in_device);
+
+  return SendFrame(SOH, ETX, GetCmdBufferP(), 9);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //          BlankCheck ()
 // Inputs:
@@ -2545,41 +3887,51 @@ C_RV40F::DEV_STAT_E C_RV40F::BlankCheck()
 
   DEV_STAT_E blank_stat = OPERATION_OK;
 
-  m_current_op_mode = DeviceOperation::BLANKCHECK;
-
-  if (false == DeviceInit())
+  if (false == BeginOperation(DeviceOperation::BLANKCHECK))
     return BLANKCHECK_ERR;
 
   if (m_fCfgClearCmdReq)
     return BLANKCHECK_ERR;
 
-  DWORD startaddress, endaddress, startaddress_in_device, endaddress_in_device;
   WORD block = 0;
-  do
+  WORD last;
+  WORD cmds_saved = 0;
+  while (block < m_sector_quantity && blank_stat == OPERATION_OK)
   {
-    // see if block has to be programmed
-    if (m_prg_api_p->GetSectorFlag(SectorOp::BLANK_CHECK_OP, block))
+    // see if block has to be checked
+    if (!m_prg_api_p->GetSectorFlag(SectorOp::BLANK_CHECK_OP, block) || block == m_option_data_block)
     {
-      if (block == m_option_data_block)
-        continue;
+      block++;
+      continue;
+    }
 
-      startaddress = m_devsectors_p[block].begin_address;
-      endaddress = m_devsectors_p[block].end_address;
-      if (block >= m_DF_block_nr)
-      {
-        endaddress -= m_ICU_S_RegionSize;
-        startaddress_in_device = GetDFAdressInDevice(startaddress);
-        endaddress_in_device = GetDFAdressInDevice(endaddress);
-      }
-      else
+    //merge the contiguous selected blocks of the same flash area (code or data flash) to one range
+    last = block;
+    while ((last + 1 < m_sector_quantity) && (last + 1 != m_option_data_block) &&
+           m_prg_api_p->GetSectorFlag(SectorOp::BLANK_CHECK_OP, last + 1) &&
+           ((last + 1 >= m_DF_block_nr) == (block >= m_DF_block_nr)) &&
+           (m_devsectors_p[last + 1].begin_address == m_devsectors_p[last].end_address + 1))
+      last++;
+
+    if (last > block)
+    { //whole range with one command, the failing sockets are not disabled here
+      if (false == SendBlankCheckCmd(block, last))
+        return WSM_BUSY_ERR;
+      if (ComparePassed(CompareDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1, 0, ERASE_TIMEOUT_MS)))
       {
-        startaddress_in_device = startaddress;
-        endaddress_in_device = endaddress;
+        cmds_saved += last - block;
+        block = last + 1;
+        if (m_prg_api_p->SysEvtChk())
+          return HARDWARE_ERR; // O.C. or Adapter change - return immediately
+        continue;
       }
+      PRINTF("C_RV40F::BlankCheck() - blocks %d..%d not blank, checking block by block\n", block, last);
+    }
 
-      WriteCmdBuffer(BLANKCHECK_CMD, startaddress_in_device, endaddress_in_device);
-
-      if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
+    //single block, or split of a failed range to find the non-blank block(s)
+    for (; block <= last && blank_stat == OPERATION_OK; block++)
+    {
+      if (false == SendBlankCheckCmd(block, block))
         return WSM_BUSY_ERR;
 
       if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
@@ -2588,13 +3940,17 @@ C_RV40F::DEV_STAT_E C_RV40F::BlankCheck()
       // check for any system events
       if (m_prg_api_p->SysEvtChk())
         return HARDWARE_ERR; // O.C. or Adapter change - return immediately
-    }                        // end of if 'sector' was to be programmed
-  } while (++block < m_sector_quantity && blank_stat == OPERATION_OK);
+    }
+  } //-- OF while (block < m_sector_quantity
+
+#if (ALG_DEBUG > 0)
+  PRINTF("C_RV40F::BlankCheck() - %d BLANKCHECK commands saved by ranges\n", cmds_saved);
+#endif
 
   if (blank_stat)
   {
     blank_stat = BLANKCHECK_ERR;
-    ResetToProgrammingMode(); //added, in order to get all devices synchronized when an error occured
+    RecoverSession(); //added, in order to get all devices synchronized when an error occured
   }
 
   return blank_stat;
@@ -2618,17 +3974,16 @@ C_RV40F::DEV_STAT_E C_RV40F::Read()
   WORD blockSize;
   BYTE stat_buffer[1];
   DWORD blankAreaSize;
+  DWORD validStart; //start of the contiguous range received with data
   WORD packetLength;
-  BYTE checksum;
-  BYTE socket_stat;
   BYTE read_cmd;
   DEV_STAT_E read_stat = OPERATION_OK;
 
-  m_current_op_mode = DeviceOperation::READ;
-
-  if (false == DeviceInit())
+  if (false == BeginOperation(DeviceOperation::READ))
     return READ_ERR;
 
+  InvalidateImageCache(); //the image is overwritten with device data
+
   DWORD startaddress, endaddress, startaddress_in_device, endaddress_in_device, address;
   BYTE frameEndType;
   volatile BYTE *srcbase = (volatile BYTE *)m_srcdata_bp;
@@ -2664,14 +4019,10 @@ C_RV40F::DEV_STAT_E C_RV40F::Read()
       //if (block >= m_DF_block_nr && m_fDF_filled0xFF == false)
       //continue; //dataflash can not be read without the information which addresses are programmed
 
-      startaddress = m_devsectors_p[block].begin_address;
-      endaddress = m_devsectors_p[block].end_address;
+      GetBlockReadRange(block, &startaddress, &endaddress);
 
       if (block >= m_DF_block_nr)
       {
-        if (m_All_skts_ICU_S_INVALID == ICU_S_RESPONSIVE_VALID)
-          endaddress -= m_ICU_S_RegionSize;
-
         startaddress_in_device = GetDFAdressInDevice(startaddress);
         endaddress_in_device = GetDFAdressInDevice(endaddress);
       }
@@ -2680,6 +4031,7 @@ C_RV40F::DEV_STAT_E C_RV40F::Read()
         startaddress_in_device = startaddress;
         endaddress_in_device = endaddress;
       }
+      MarkImageValid(block, startaddress, endaddress - startaddress + 1, false); //blank areas are not received
 
       areaSize = endaddress_in_device - startaddress_in_device + 1;
       if (areaSize < MAX_PAGE_SIZE)
@@ -2703,54 +4055,17 @@ C_RV40F::DEV_STAT_E C_RV40F::Read()
           return READ_ERR;
       }
 
-      m_comm_buffer[0] = 0x00;
       address = startaddress;
+      validStart = startaddress;
       do
       {
         if (false == SendFrame(SOD, ETX, GetCmdBufferP(), 1)) //reverse ACK
           return WSM_BUSY_ERR;
-        socket_stat = WaitUntilDeviceReady(DeviceOperation::READ, LOGIC_1, DEFAULT_TIMEOUT);
-        if (CompareFailed(socket_stat))
-        {
-          if (!m_prg_api_p->MisCompare(DeviceOperation::READ, socket_stat, 0, LOGIC_1))
-          {
-            m_prg_api_p->Write2EventLog(" SO timeout error!");
-            return READ_ERR;
-          }
-        }
-        //Receive Data Frame
-        //read 3 Bytes: SOD + LN
-        if (m_fpga_p->SerialRead(&m_comm_buffer[0], 24))
-          return READ_ERR;
-        packetLength = ((WORD)m_comm_buffer[1] << 8) | (WORD)m_comm_buffer[2];
-        if (packetLength > (MAX_PAGE_SIZE + 1)) //RES + max. LEN
-        {
-          m_prg_api_p->Write2EventLog("Packet size exceeded buffer limit");
-          return READ_ERR;
-        }
-        //read the rest of the packet
-        if (m_fpga_p->SerialRead(&m_comm_buffer[3], 8 * (packetLength + 2)))
-          return READ_ERR;
-        //we have all data now
-        checksum = 0;
-        for (int i = 1; i <= (packetLength + 3); i++) //incl. CS
-          checksum += m_comm_buffer[i];
-
-        if (checksum)
-        {
-          m_prg_api_p->Write2EventLog("Checksum ERROR while executing READ_VALID_DATA cmd");
+        //Receive Data Frame: the data is received directly at its image address
+        if (false == ReceiveFrameToImage(read_cmd, &m_srcdata_bp[address], endaddress - address + 1, &packetLength))
           return READ_ERR;
-        }
         if (m_comm_buffer[3] == read_cmd)
         {
-          memcpy(&m_srcdata_bp[address], &m_comm_buffer[4], packetLength - 1);
-          if (!(m_DF_write_unit == 16))
-          {
-            if (block >= m_DF_block_nr)
-              memset(&m_srcdata_bp[DF_MARKER_OFFSET + address], 0x00, packetLength - 1); //set MARKER for valid data -> then the image can be used for LFM jobs.
-            else
-              memset(&m_srcdata_bp[CF_MARKER_OFFSET + (address / 256)], 0x00, (packetLength - 1) / 256); //set MARKER for valid data -> then the image can be used for LFM jobs.
-          }
           address += packetLength - 1;
         }
         else if (m_comm_buffer[3] == EXTENDED_READ_CMD_ERR)
@@ -2758,7 +4073,9 @@ C_RV40F::DEV_STAT_E C_RV40F::Read()
           if (m_comm_buffer[2] == 5) // a length value 5 and NACK points to blank data ----recored the blank area size
           {
             blankAreaSize = ((DWORD)m_comm_buffer[4] << 24) | ((DWORD)m_comm_buffer[5] << 16) | ((DWORD)m_comm_buffer[6] << 8) | (DWORD)m_comm_buffer[7];
+            MarkImageValid(block, validStart, address - validStart);
             address += blankAreaSize;
+            validStart = address;
             continue; //blank area contains invalid data, therefore skip it
           }
           else
@@ -2773,15 +4090,238 @@ C_RV40F::DEV_STAT_E C_RV40F::Read()
           return READ_ERR;
         }
 
-      } while (address <= endaddress && read_stat == OPERATION_OK);
+      } while (address <= endaddress && read_stat == OPERATION_OK);
+      MarkImageValid(block, validStart, address - validStart);
+
+      // check for any system events
+      if (m_prg_api_p->SysEvtChk())
+        return HARDWARE_ERR; // O.C. or Adapter change - return immediately
+    }                        // end of if 'sector' was to be programmed
+  } while (++block < m_sector_quantity && read_stat == OPERATION_OK);
+
+  BuildExtents(); //the markers are set for the read data
+
+  if (read_stat == OPERATION_OK && m_fReadCompareAll)
+    read_stat = CompareSocketsToImage();
+
+  return read_stat;
+}
+
+// Returns the image range of a block handled by Read(): data flash without the ICU-S region, if it is valid.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+void C_RV40F::GetBlockReadRange(const WORD block, DWORD *startaddress_p, DWORD *endaddress_p)
+{
+  *startaddress_p = m_devsectors_p[block].begin_address;
+  *endaddress_p = m_devsectors_p[block].end_address;
+
+  if (block >= m_DF_block_nr && m_All_skts_ICU_S_INVALID == ICU_S_RESPONSIVE_VALID)
+    *endaddress_p -= m_ICU_S_RegionSize;
+}
+
+// Gang mode: blank checks startInDev..startInDev+areaSize-1 on all enabled sockets (the read socket reported the area blank).
+// The sockets with data in the area are collected in *diff_p, *frames_p counts the failing ranges.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+C_RV40F::DEV_STAT_E C_RV40F::CompareBlankRange(DWORD startInMem, DWORD startInDev, DWORD areaSize, SOCKET_STATUS_T *diff_p, WORD *frames_p)
+{
+  SOCKET_STATUS_T frame_stat;
+
+  m_current_CMD = BLANKCHECK_CMD;
+  WriteCmdBuffer(BLANKCHECK_CMD, startInDev, startInDev + areaSize - 1);
+  if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
+    return WSM_BUSY_ERR;
+
+  frame_stat = CompareDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1, 0, ERASE_TIMEOUT_MS);
+  if (CompareFailed(frame_stat))
+  {
+    if (*frames_p < HYBRID_LOG_PAGES)
+    {
+      sprintf(msgbuff, "Read compare: sockets %Xh not blank at 0x%08X..0x%08X", (WORD)frame_stat, startInMem, startInMem + areaSize - 1);
+      m_prg_api_p->Write2EventLog(msgbuff);
+    }
+    (*frames_p)++;
+    *diff_p |= frame_stat;
+  }
+
+  return OPERATION_OK;
+}
+
+// Gang mode: compares the range of a block read by Read() with all enabled sockets. The ranges received with data
+// are read back and compared (CompareReadRange), the ranges reported blank are blank checked (CompareBlankRange).
+// READ_CMD (m_DF_write_unit == 16) returns the whole block as data, there are no markers.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+C_RV40F::DEV_STAT_E C_RV40F::CompareBlockToImage(const WORD block, SOCKET_STATUS_T *diff_p, WORD *frames_p)
+{
+  DWORD startaddress, endaddress, address, runStart;
+  DWORD markerOffset, markerUnit, unit, marker;
+  bool fData, fRunData = true;
+  DEV_STAT_E compare_stat = OPERATION_OK;
+
+  GetBlockReadRange(block, &startaddress, &endaddress);
+
+  if (block >= m_DF_block_nr)
+  {
+    markerOffset = DF_MARKER_OFFSET;
+    markerUnit = 1;
+    unit = m_DF_write_unit;
+  }
+  else
+  {
+    markerOffset = CF_MARKER_OFFSET;
+    markerUnit = MIN_PAGE_SIZE;
+    unit = MIN_PAGE_SIZE;
+  }
+
+  runStart = startaddress;
+  for (address = startaddress; compare_stat == OPERATION_OK; address += unit)
+  {
+    if (address > endaddress)
+    { //end of block: close the open range
+      address = endaddress + 1;
+      fData = !fRunData;
+    }
+    else if (m_DF_write_unit == 16)
+      fData = true;
+    else
+    { //a unit contains data, if any of its markers is 0x00 (see ScanExtents)
+      for (marker = 0; marker < unit / markerUnit; marker++)
+      {
+        if (0 == GetDataFromRam_8Bit(markerOffset + address / markerUnit + marker, (DWORD)m_srcdata_bp))
+          break;
+      }
+      fData = (marker < unit / markerUnit);
+    }
+
+    if (address == startaddress)
+      fRunData = fData;
+    if (fData == fRunData)
+      continue;
+
+    if (block >= m_DF_block_nr)
+    {
+      if (fRunData)
+        compare_stat = CompareReadRange(runStart, GetDFAdressInDevice(runStart), address - runStart, diff_p, frames_p);
+      else
+        compare_stat = CompareBlankRange(runStart, GetDFAdressInDevice(runStart), address - runStart, diff_p, frames_p);
+    }
+    else
+    {
+      if (fRunData)
+        compare_stat = CompareReadRange(runStart, runStart, address - runStart, diff_p, frames_p);
+      else
+        compare_stat = CompareBlankRange(runStart, runStart, address - runStart, diff_p, frames_p);
+    }
+    if (address > endaddress)
+      break;
+    runStart = address;
+    fRunData = fData;
+  }
+
+  return compare_stat;
+}
+
+// Gang mode: reads startInDev..startInDev+areaSize-1 with READ_CMD on all enabled sockets and compares each frame
+// with the image at startInMem. The sockets of differing frames are collected in *diff_p, *frames_p counts the frames.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+C_RV40F::DEV_STAT_E C_RV40F::CompareReadRange(DWORD startInMem, DWORD startInDev, DWORD areaSize, SOCKET_STATUS_T *diff_p, WORD *frames_p)
+{
+  volatile BYTE *srcbase = (volatile BYTE *)m_srcdata_bp;
+  SOCKET_STATUS_T frame_stat;
+  DWORD offset;
+  WORD frameSize;
+
+  m_current_CMD = READ_CMD;
+  WriteCmdBuffer(READ_CMD, startInDev, startInDev + areaSize - 1);
+  if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
+    return WSM_BUSY_ERR;
+
+  frame_stat = CompareDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1);
+  if (CompareFailed(frame_stat))
+  { //command rejected: these sockets do not send data
+    *diff_p |= frame_stat;
+    if (!m_prg_api_p->MisCompare(DeviceOperation::VERIFY, frame_stat, startInMem, READ_CMD))
+      return READ_ERR;
+  }
+
+  for (offset = 0; offset < areaSize; offset += frameSize)
+  {
+    frameSize = (areaSize - offset > MAX_PAGE_SIZE) ? MAX_PAGE_SIZE : (WORD)(areaSize - offset);
+
+    if (false == SendFrame(SOD, ETX, GetCmdBufferP(), 1)) //reverse ACK
+      return WSM_BUSY_ERR;
+
+    frame_stat = CompareDataFrame((offset + frameSize < areaSize) ? ETB : ETX, (BYTE *)(srcbase + startInMem + offset), frameSize, frameSize, READ_CMD);
+    if (CompareFailed(frame_stat))
+    {
+      if (*frames_p < HYBRID_LOG_PAGES)
+      {
+        sprintf(msgbuff, "Read compare: sockets %Xh differ at 0x%08X..0x%08X", (WORD)frame_stat, startInMem + offset, startInMem + offset + frameSize - 1);
+        m_prg_api_p->Write2EventLog(msgbuff);
+      }
+      (*frames_p)++;
+      *diff_p |= frame_stat;
+    }
+  }
+
+  return OPERATION_OK;
+}
 
-      // check for any system events
-      if (m_prg_api_p->SysEvtChk())
-        return HARDWARE_ERR; // O.C. or Adapter change - return immediately
-    }                        // end of if 'sector' was to be programmed
-  } while (++block < m_sector_quantity && read_stat == OPERATION_OK);
+// Compares the image just read from the read socket with all enabled sockets (m_fReadCompareAll).
+// All blocks read by Read() (PROGRAM_SECTOR_OP) are compared: data read back, blank areas blank checked.
+// The differing sockets are failed.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ //
+C_RV40F::DEV_STAT_E C_RV40F::CompareSocketsToImage(void)
+{
+  WORD read_mask = LM_Phapi::Get()->ActiveDUTMaskGet();
+  WORD skt_mask = 0;
+  SOCKET_STATUS_T diff_mask = 0;
+  WORD frames = 0;
+  DEV_STAT_E compare_stat = OPERATION_OK;
+  WORD block;
+  int nDUT;
 
-  return read_stat;
+  //sockets still enabled by the system (failed sockets are not compared again)
+  for (nDUT = 0; nDUT < MAX_SOCKET_NUM; nDUT++)
+  {
+    if (m_prg_api_p->SocketStatusGet(SocketNumChange(nDUT + 1)) == SOCKET_ENABLE)
+      skt_mask |= 1 << nDUT;
+  }
+  skt_mask |= read_mask;
+  if ((skt_mask & ~read_mask) == 0)
+    return OPERATION_OK; //no other socket
+
+  LM_Phapi::Get()->SetGangSktMode(skt_mask);
+  m_current_op_mode = DeviceOperation::VERIFY;
+
+  if (false == m_fGangInitialized)
+  { //Read() was the first operation: only the read socket was initialized (READ mode). Initialize all sockets.
+    ResetToProgrammingMode();
+    if (false == DeviceInit())
+    {
+      LM_Phapi::Get()->SetGangSktMode(read_mask);
+      m_current_op_mode = DeviceOperation::READ;
+      return READ_ERR;
+    }
+    skt_mask = LM_Phapi::Get()->ActiveDUTMaskGet(); //without the sockets, which failed the initialization
+  }
+
+  for (block = 0; block < m_sector_quantity && compare_stat == OPERATION_OK; block++)
+  {
+    if (m_prg_api_p->GetSectorFlag(SectorOp::PROGRAM_SECTOR_OP, block) && block != m_option_data_block)
+      compare_stat = CompareBlockToImage(block, &diff_mask, &frames);
+  }
+
+  sprintf(msgbuff, "Read compare: sockets %Xh compared with socket mask %Xh, %d frames/ranges differ (sockets %Xh).",
+          skt_mask & ~read_mask, read_mask, frames, (WORD)diff_mask);
+  m_prg_api_p->Write2EventLog(msgbuff);
+
+  LM_Phapi::Get()->SetGangSktMode(read_mask);
+  m_current_op_mode = DeviceOperation::READ;
+
+  if (compare_stat == OPERATION_OK && CompareFailed(diff_mask & ~read_mask))
+    if (!m_prg_api_p->MisCompare(DeviceOperation::VERIFY, diff_mask & ~read_mask, 0, 0))
+      compare_stat = READ_ERR;
+
+  return compare_stat;
 }
 
 //*************************************************************************
@@ -2799,16 +4339,13 @@ C_RV40F::DEV_STAT_E C_RV40F::Erase()
 
   DWORD dataFlashSize;
   DWORD DF_startaddress_in_device, DF_endaddress_in_device;
-  DWORD address, startaddress_in_device;
   bool fResetReq = false;
-  SOCKET_STATUS_E skt_stat;
   BYTE skt_mask, failed_skt_mask;
   int nDUT, i;
+  DWORD start_ms;
   DEV_STAT_E erase_stat = OPERATION_OK;
 
-  m_current_op_mode = DeviceOperation::ERASE;
-
-  if (false == DeviceInit())
+  if (false == BeginOperation(DeviceOperation::ERASE))
     return BLOCK_ERASE_ERR;
 
   if ((m_optionSupportedByDev & ICU_S) && (m_optionSelectedByUser & ICU_S))
@@ -2821,36 +4358,24 @@ C_RV40F::DEV_STAT_E C_RV40F::Erase()
     }
   }
 
-  WORD block = 0;
-  do
+  if (m_fIncremental)
   {
-    // see if block has to be erased
-    if (m_prg_api_p->GetSectorFlag(SectorOp::ERASE_SECTOR_OP, block))
-    {
-      if (block == m_option_data_block || block >= m_DF_block_nr)
-        continue;
-
-      startaddress_in_device = m_devsectors_p[block].begin_address;
-
-      WriteCmdBuffer(ERASE_CMD, startaddress_in_device, 0);
-
-      if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 5))
-        return WSM_BUSY_ERR;
+    erase_stat = FindUnchangedBlocks();
+    if (erase_stat != OPERATION_OK)
+      return erase_stat;
+  }
 
-      if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
-      {
-        erase_stat = BLOCK_ERASE_ERR;
-        PRINTF("C_RV40F::Erasing failed in block %d\n", block);
-      }
+  m_erase_cmds_saved = 0;
+  m_erase_blocks = 0;
+  m_erase_ms = 0;
+  start_ms = GetTimeMs();
 
-      // check for any system events
-      if (m_prg_api_p->SysEvtChk())
-        return HARDWARE_ERR; // O.C. or Adapter change - return immediately
-    }                        // end of if 'sector' was to be programmed
-  } while (++block < m_sector_quantity && erase_stat == OPERATION_OK);
+  erase_stat = EraseCFBlocks(m_sector_quantity);
+  if (erase_stat == WSM_BUSY_ERR || erase_stat == HARDWARE_ERR)
+    return erase_stat;
 
   // check if DF has to be erased
-  block = m_DF_block_nr;
+  WORD block = m_DF_block_nr;
   do
   {
     if (m_prg_api_p->GetSectorFlag(SectorOp::ERASE_SECTOR_OP, block))
@@ -2867,51 +4392,39 @@ C_RV40F::DEV_STAT_E C_RV40F::Erase()
         DF_endaddress_in_device = GetDFAdressInDevice(m_devsectors_p[m_DF_block_nr].end_address);
         if (false == GetSockets_ICU_S_Status()) //skts with different validation status
         {
-          //Collect data socket by socket
+          //gang mode per ICU-S status: sockets with invalid ICU-S area, then sockets with valid ICU-S area
           failed_skt_mask = 0;
           WORD socket_mask = LM_Phapi::Get()->ActiveDUTMaskGet();
-          m_current_op_mode = DeviceOperation::READ;
-          for (nDUT = MAX_SOCKET_NUM - 1; nDUT >= 0; nDUT--)
+
+          skt_mask = Get_ICU_S_SocketMask(ICU_S_RESPONSIVE_INVALID);
+          if (skt_mask)
           {
-            // check only active sockets
-            skt_stat = m_prg_api_p->SocketStatusGet(SocketNumChange(nDUT + 1));
-            if (skt_stat == SOCKET_ENABLE)
-            {
-              // activate this one socket for reading
-              // Note: ALL OTHER SOCKETS WILL BE DISABLED
-              skt_mask = 1 << nDUT;
-              LM_Phapi::Get()->SetSingleSktMode((WORD)(nDUT + 1));
+            LM_Phapi::Get()->SetGangSktMode(skt_mask);
+            if (OPERATION_OK != Erase_DataFlash_Area(DF_startaddress_in_device, DF_endaddress_in_device))
+              failed_skt_mask |= skt_mask;
+            failed_skt_mask |= skt_mask & ~LM_Phapi::Get()->ActiveDUTMaskGet(); //disabled by MisCompare() within the pass
+          }
 
-              if (m_ICU_S_Status[nDUT] == ICU_S_RESPONSIVE_INVALID)
-              {
-                if (OPERATION_OK != Erase_DataFlash_Area(DF_startaddress_in_device, DF_endaddress_in_device))
-                  failed_skt_mask |= skt_mask;
-              }
-              else
+          skt_mask = Get_ICU_S_SocketMask(ICU_S_RESPONSIVE_VALID);
+          if (skt_mask && !(m_optionSupportedByDev & ICU_S_ERASE_PROHIBITED))
+          {
+            LM_Phapi::Get()->SetGangSktMode(skt_mask);
+            if (OPERATION_OK != Erase_ICU_Area())
+              failed_skt_mask |= skt_mask;
+            failed_skt_mask |= skt_mask & ~LM_Phapi::Get()->ActiveDUTMaskGet(); //disabled by MisCompare() within the pass
+            if ((skt_mask & ~failed_skt_mask) != 0)
+            {
+              for (nDUT = 0; nDUT < MAX_SOCKET_NUM; nDUT++)
               {
-                if ((m_ICU_S_Status[nDUT] == ICU_S_RESPONSIVE_VALID) &&  (!(m_optionSupportedByDev & ICU_S_ERASE_PROHIBITED)))
-                {
-                  if (OPERATION_OK != Erase_ICU_Area())
-                  {
-                    failed_skt_mask |= skt_mask;
-                    erase_stat == BLOCK_ERASE_ERR;
-                  }
-
-                  if (erase_stat == OPERATION_OK)
-                  {
-                    m_ICU_S_Status[nDUT] == ICU_S_RESPONSIVE_INVALID;
-                    fResetReq = true; //ICU-S protection is lifted after the next RESET
-                  }
-                } //end if((m_ICU_S_Status[nDUT] == ICU_S_RESPONSIVE_VALID) && (!(m_optionSupportedByDev & ICU_S_ERASE_PROHIBITED)))
+                if ((skt_mask & ~failed_skt_mask) & (1 << nDUT)) //ICU-S erased on the surviving sockets only
+                  m_ICU_S_Status[nDUT] = ICU_S_RESPONSIVE_INVALID;
               }
+              fResetReq = true; //ICU-S protection is lifted after the next RESET
+            }
+          }
 
-              if (failed_skt_mask & skt_mask)
-                continue;
-            } //-- OF if (skt_stat==SOCKET_ENABLE)
-          }   //-- OF for (nDUT=MAX_SOCKET_NUM-1; nDUT>=0; nDUT--)
-          // Re-Enable all enabled sockets
-          LM_Phapi::Get()->SetGangSktMode(socket_mask);
-          m_current_op_mode = DeviceOperation::ERASE;
+          // Re-Enable the enabled sockets, which did not fail
+          LM_Phapi::Get()->SetGangSktMode(socket_mask & ~failed_skt_mask);
 
           // disable the DUT
           if (CompareFailed(failed_skt_mask))
@@ -2956,12 +4469,7 @@ C_RV40F::DEV_STAT_E C_RV40F::Erase()
   //do options area last and only if necessary
   if (erase_stat == OPERATION_OK && m_fCfgClearCmdReq && m_prg_api_p->GetSectorFlag(SectorOp::ERASE_SECTOR_OP, m_option_data_block))
   {
-    for (address = 0; address < OPBT_LENGTH; address++)
-    {
-      if (GetDataFromRam_8Bit(OPBT_OFFSET(0) + address, (DWORD)m_srcdata_bp) != 0xFF)
-        break;
-    }
-    if (address == OPBT_LENGTH)
+    if (MemScan_AllEqual(&m_srcdata_bp[OPBT_OFFSET(0)], OPBT_LENGTH, 0xFF))
     { //abort if OPBT area empty. Otherwise device could be rendered useless
       m_prg_api_p->Write2EventLog("OPBT0-7 settings missed. Erasing aborted to prevent unprogrammed option bytes!");
       return BLOCK_ERASE_ERR;
@@ -2977,6 +4485,13 @@ C_RV40F::DEV_STAT_E C_RV40F::Erase()
     m_fCfgClearCmdReq = false;
   } //-- OF if (m_prg_api_p->GetSectorFlag(SectorOp::ERASE_SECTOR_OP, m_option_data_block))
 
+  if (m_fRangeErase && m_erase_blocks)
+  { //estimated time saved: saved commands * measured erase time per block
+    sprintf(msgbuff, "Range erase: %d ERASE commands saved, approx. %d ms saved (%d ms per block), erase time %d ms.",
+            m_erase_cmds_saved, m_erase_cmds_saved * m_erase_ms / m_erase_blocks, m_erase_ms / m_erase_blocks, GetTimeMs() - start_ms);
+    m_prg_api_p->Write2EventLog(msgbuff);
+  }
+
   if (fResetReq)
     ResetToProgrammingMode();
 
@@ -3001,22 +4516,15 @@ C_RV40F::DEV_STAT_E C_RV40F::Program()
   PRINTF("C_RV40F::Program()\n"); // debug statements
 #endif
 
-  volatile BYTE *srcbase = (volatile BYTE *)m_srcdata_bp;
   DEV_STAT_E prog_stat = OPERATION_OK;
 
   DWORD startaddress, endaddress;
-  DWORD startaddress_in_device, endaddress_in_device, address;
-  BYTE frameEndType;
-  DWORD areaSize;
-  WORD blockSize;
+  DWORD startaddress_in_device, endaddress_in_device;
   BYTE socket_stat;
-  SOCKET_STATUS_E skt_stat;
   BYTE skt_mask, failed_skt_mask;
-  int nDUT;
-
-  m_current_op_mode = DeviceOperation::PROGRAM;
+  int icuStatus;
 
-  if (false == DeviceInit())
+  if (false == BeginOperation(DeviceOperation::PROGRAM))
     return PROGRAM_ERR;
 
   WORD block = 0;
@@ -3036,6 +4544,8 @@ C_RV40F::DEV_STAT_E C_RV40F::Program()
       }
       if (block >= m_DF_block_nr)
         continue; //dataflash handled separately
+      if (m_fUnchangedValid && m_block_unchanged_p[block])
+        continue; //incremental programming: device block equals image (checked in Erase() of this part)
 
       startaddress = m_devsectors_p[block].begin_address;
       endaddress = m_devsectors_p[block].end_address;
@@ -3048,81 +4558,22 @@ C_RV40F::DEV_STAT_E C_RV40F::Program()
           continue; //skip
         if (CF_IsAreaFragmented(startaddress, endaddress - startaddress + 1))
         { //non-homogeneous CF area, it contains gaps
-          //program areas with data only
-          address = startaddress;
-          do
-          {
-            //search for words to be programmed (marked with 0x00 in the MARKER area)
-            while (GetDataFromRam_8Bit(address / MIN_PAGE_SIZE + CF_MARKER_OFFSET, (DWORD)m_srcdata_bp) && address <= endaddress)
-              address += MIN_PAGE_SIZE;
-            if (address > endaddress)
-              break; //reached end of CF sector
-            startaddress = address;
-            do
-            {
-              address += MIN_PAGE_SIZE;
-              if (0 == (address % MAX_PAGE_SIZE))
-                break;
-            } while (GetDataFromRam_8Bit(address / MIN_PAGE_SIZE + CF_MARKER_OFFSET, (DWORD)m_srcdata_bp) == 0);
-
-            startaddress_in_device = startaddress;
-            endaddress_in_device = address - 1;
-            areaSize = endaddress_in_device - startaddress_in_device + 1;
-
-            WriteCmdBuffer(PROGRAM_CMD, startaddress_in_device, endaddress_in_device);
-
-            if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
-              return WSM_BUSY_ERR;
-
-            if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
-              return PROGRAM_ERR;
-
-            if (false == SendFrame(SOD, ETX, (BYTE *)(srcbase + startaddress), (WORD)areaSize, PROGRAM_CMD))
-              return WSM_BUSY_ERR;
-
-            if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
-            {
-              prog_stat = PROGRAM_ERR;
-              PRINTF("C_RV40F::Programming fail at address 0x%X\n", startaddress);
-            }
-          } while (address <= endaddress && prog_stat == OPERATION_OK);
+          //program areas with data only: one PROGRAM command per extent of this block
+          prog_stat = ProgramExtents(m_CF_extent_p, m_CF_extent_cnt, startaddress, endaddress);
+          if (prog_stat == WSM_BUSY_ERR)
+            return prog_stat;
 
           continue;
         }
       } //-- OF if (m_fCF_filled0xFF == false)
 
-      areaSize = endaddress_in_device - startaddress_in_device + 1;
-      if (areaSize < MAX_PAGE_SIZE)
-        blockSize = (WORD)areaSize;
+      if (m_fCF_skip0xFF && m_prg_api_p->GetSectorFlag(SectorOp::ERASE_SECTOR_OP, block) &&
+          m_prg_api_p->JobFlagGet(AlgorithmTypes::DEVICE_ERASE_FLAG))
+        prog_stat = ProgramExtents(m_CF_data_extent_p, m_CF_data_extent_cnt, startaddress, endaddress); //block is erased: skip 0xFF units
       else
-        blockSize = MAX_PAGE_SIZE;
-
-      WriteCmdBuffer(PROGRAM_CMD, startaddress_in_device, endaddress_in_device);
-
-      if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 9))
-        return WSM_BUSY_ERR;
-
-      if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
-        return PROGRAM_ERR;
-
-      for (address = startaddress;
-           address <= endaddress && prog_stat == OPERATION_OK;
-           address += blockSize)
-      {
-        if (address + blockSize > endaddress) //last data block?
-          frameEndType = ETX;                 //end of all data
-        else
-          frameEndType = ETB; //end of block
-
-        if (false == SendFrame(SOD, frameEndType, (BYTE *)(srcbase + address), blockSize, PROGRAM_CMD))
-          return WSM_BUSY_ERR;
-
-        if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
-        {
-          prog_stat = PROGRAM_ERR;
-          PRINTF("C_RV40F::Programming fail at 0x%X\n", address);
-        }
-      }
+        prog_stat = ProgramRange(startaddress, startaddress_in_device, endaddress_in_device - startaddress_in_device + 1);
+      if (prog_stat == WSM_BUSY_ERR)
+        return prog_stat;
 
       // check for any system events
       if (m_prg_api_p->SysEvtChk())
@@ -3140,41 +4591,29 @@ C_RV40F::DEV_STAT_E C_RV40F::Program()
   {
     if (m_prg_api_p->GetSectorFlag(SectorOp::PROGRAM_SECTOR_OP, block))
     {
-      //Collect data socket by socket
+      //gang mode per ICU-S status: each partition with its own ICU-S region size
       failed_skt_mask = 0;
       WORD socket_mask = LM_Phapi::Get()->ActiveDUTMaskGet();
-      m_current_op_mode = DeviceOperation::READ;
-      for (nDUT = MAX_SOCKET_NUM - 1; nDUT >= 0; nDUT--)
+      for (icuStatus = ICU_S_RESPONSIVE_VALID; icuStatus <= ICU_S_RESPONSIVE_INVALID; icuStatus++)
       {
-        // check only active sockets
-        skt_stat = m_prg_api_p->SocketStatusGet(SocketNumChange(nDUT + 1));
-        if (skt_stat == SOCKET_ENABLE)
+        skt_mask = Get_ICU_S_SocketMask(icuStatus);
+        if (skt_mask == 0)
+          continue;
+        LM_Phapi::Get()->SetGangSktMode(skt_mask);
+        for (block = m_DF_block_nr; block < m_sector_quantity; block++)
         {
-          // activate this one socket for reading
-          // Note: ALL OTHER SOCKETS WILL BE DISABLED
-          skt_mask = 1 << nDUT;
-          LM_Phapi::Get()->SetSingleSktMode((WORD)(nDUT + 1));
-          do
-          {
-            if (m_ICU_S_Status[nDUT] == ICU_S_RESPONSIVE_INVALID)
-            {
-              if (OPERATION_OK != Program_DataFlash_Area(block, 0))
-                failed_skt_mask |= skt_mask;
-            } //-- OF if(m_ICU_S_Status[nDUT])
-            else if (m_ICU_S_Status[nDUT] == ICU_S_RESPONSIVE_VALID)
-            {
-              if (OPERATION_OK != Program_DataFlash_Area(block, m_ICU_S_RegionSize))
-                failed_skt_mask |= skt_mask;
-            }
-          } while (++block < m_sector_quantity && prog_stat == OPERATION_OK);
-
-          if (failed_skt_mask & skt_mask)
+          if (!m_prg_api_p->GetSectorFlag(SectorOp::PROGRAM_SECTOR_OP, block))
             continue;
-        } //-- OF if (skt_stat==SOCKET_ENABLE)
-      }   //-- OF for (nDUT=MAX_SOCKET_NUM-1; nDUT>=0; nDUT--)
-      // Re-Enable all enabled sockets
-      LM_Phapi::Get()->SetGangSktMode(socket_mask);
-      m_current_op_mode = DeviceOperation::PROGRAM;
+          if (OPERATION_OK != Program_DataFlash_Area(block, (icuStatus == ICU_S_RESPONSIVE_VALID) ? m_ICU_S_RegionSize : 0))
+          {
+            failed_skt_mask |= skt_mask;
+            break;
+          }
+        }
+        failed_skt_mask |= skt_mask & ~LM_Phapi::Get()->ActiveDUTMaskGet(); //disabled by MisCompare() within the pass
+      }
+      // Re-Enable the enabled sockets, which did not fail
+      LM_Phapi::Get()->SetGangSktMode(socket_mask & ~failed_skt_mask);
 
       // disable the DUT
       if (CompareFailed(failed_skt_mask))
@@ -3229,23 +4668,21 @@ C_RV40F::DEV_STAT_E C_RV40F::Verify()
   DWORD startaddress, endaddress;
   DWORD startaddress_in_device, endaddress_in_device;
   DWORD address;
+  DWORD ext;
   BYTE frameEndType;
   BYTE data_buffer[16];
   WORD block;
   WORD blockSize;
-  DWORD areaSize;
   DWORD checkSum; //CRC32
   DEV_STAT_E verify_stat = OPERATION_OK;
-  SOCKET_STATUS_E skt_stat;
   BYTE skt_mask, failed_skt_mask;
-  int nDUT;
-
-  m_current_op_mode = current_op_stat_p->operation;
-  DEV_OP_E saved_current_op_mode = m_current_op_mode;
+  int icuStatus;
 
-  if (false == DeviceInit())
+  if (false == BeginOperation(current_op_stat_p->operation))
     return VERIFY_ERR;
 
+  memset(m_crc_fail_p, 0, m_sector_quantity * sizeof(SOCKET_STATUS_T));
+
   //blockwise operation
   block = 0;
   do
@@ -3285,34 +4722,33 @@ C_RV40F::DEV_STAT_E C_RV40F::Verify()
           continue; //skip
         if (CF_IsAreaFragmented(startaddress, endaddress - startaddress + 1))
         { //non-homogeneous CF area, it contains gaps
-          //verify areas with data only
-          address = startaddress;
-          do
+          //verify areas with data only: one READ command per extent of this block
+          for (ext = FindExtent(m_CF_extent_p, m_CF_extent_cnt, startaddress);
+               ext < m_CF_extent_cnt && m_CF_extent_p[ext].start <= endaddress && verify_stat == OPERATION_OK;
+               ext++)
           {
-            //search for words to be programmed (marked with 0x00 in the MARKER area)
-            while (GetDataFromRam_8Bit(address / MIN_PAGE_SIZE + CF_MARKER_OFFSET, (DWORD)m_srcdata_bp) && address <= endaddress)
-              address += MIN_PAGE_SIZE;
-            if (address > endaddress)
-              break; //reached end of CF sector
-            startaddress = address;
-            do
-            {
-              address += MIN_PAGE_SIZE;
-              if (0 == (address % MAX_PAGE_SIZE))
-                break;
-            } while (GetDataFromRam_8Bit(address / MIN_PAGE_SIZE + CF_MARKER_OFFSET, (DWORD)m_srcdata_bp) == 0);
+            startaddress_in_device = (m_CF_extent_p[ext].start > startaddress) ? m_CF_extent_p[ext].start : startaddress;
+            endaddress_in_device = m_CF_extent_p[ext].start + m_CF_extent_p[ext].size - 1;
+            if (endaddress_in_device > endaddress)
+              endaddress_in_device = endaddress;
 
-            startaddress_in_device = startaddress;
-            endaddress_in_device = address - 1;
-            areaSize = endaddress_in_device - startaddress_in_device + 1;
-
-            verify_stat = VerifyArea(startaddress, startaddress_in_device, areaSize);
-          } while (address <= endaddress && verify_stat == OPERATION_OK);
+            verify_stat = VerifyArea(startaddress_in_device, startaddress_in_device, endaddress_in_device - startaddress_in_device + 1);
+          }
 
           continue;
         }
       } //-- OF if (m_fCF_filled0xFF == false)
 
+      if (m_VerifyType == HYBRID_VERIFY)
+      { //CRC check only, failing blocks are verified page by page after the last block
+        verify_stat = CheckSectorCRC(block, &m_crc_fail_p[block]);
+        if (verify_stat == WSM_BUSY_ERR)
+          return verify_stat;
+        if (m_prg_api_p->SysEvtChk())
+          return HARDWARE_ERR; // O.C. or Adapter change - return immediately
+        continue;
+      }
+
       if (m_VerifyType == CHECKSUM_VERIFY)
         m_current_CMD = CRC_CMD;
       else
@@ -3324,17 +4760,14 @@ C_RV40F::DEV_STAT_E C_RV40F::Verify()
       if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
         return VERIFY_ERR;
 
-      checkSum = 0xFFFFFFFF; //init checksum
-      //verify loop
-      for (address = startaddress;
-           address <= endaddress && verify_stat == OPERATION_OK;
-           address += MAX_PAGE_SIZE)
+      if (m_current_CMD == CRC_CMD)
+        checkSum = GetSectorCRC(block); //CRC32 of the whole block
+      else
       {
-        if (m_current_CMD == CRC_CMD)
-        {
-          checkSum = update_crc(checkSum, (BYTE *)(srcbase + address), MAX_PAGE_SIZE); //CRC32
-        }
-        else
+        //verify loop
+        for (address = startaddress;
+             address <= endaddress && verify_stat == OPERATION_OK;
+             address += MAX_PAGE_SIZE)
         {
           if (address + MAX_PAGE_SIZE > endaddress) //last data block?
             frameEndType = ETX;                     //end of all data
@@ -3343,14 +4776,16 @@ C_RV40F::DEV_STAT_E C_RV40F::Verify()
 
           if (false == SendFrame(SOD, frameEndType, (BYTE *)(srcbase + address), MAX_PAGE_SIZE, VERIFY_CMD))
             return WSM_BUSY_ERR;
+          if (frameEndType == ETB) //stage the next page while the device is busy
+            PreloadFrame(SOD, (BYTE *)(srcbase + address + MAX_PAGE_SIZE), MAX_PAGE_SIZE, VERIFY_CMD);
 
           if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
           {
             verify_stat = VERIFY_ERR;
             PRINTF("C_RV40F::Verify fail at 0x%X\n", address);
           }
-        } //if (m_current_CMD ==
-      }   //-- OF for (address = startaddress;
+        } //-- OF for (address = startaddress;
+      }   //if (m_current_CMD ==
 
       if (m_current_CMD == CRC_CMD)
       {
@@ -3376,50 +4811,46 @@ C_RV40F::DEV_STAT_E C_RV40F::Verify()
   if (verify_stat != OPERATION_OK)
     return verify_stat;
 
+  if (m_VerifyType == HYBRID_VERIFY)
+  { //localize the CRC mismatches
+    for (block = 0; block < m_DF_block_nr && verify_stat == OPERATION_OK; block++)
+    {
+      if (CompareFailed(m_crc_fail_p[block]))
+        verify_stat = LocalizeCRCFail(block, m_crc_fail_p[block]);
+    }
+    if (verify_stat != OPERATION_OK)
+      return verify_stat;
+  }
+
   //data flash verify
   block = m_DF_block_nr;
   if ((m_optionSupportedByDev & ICU_S) && (!(GetSockets_ICU_S_Status())))
   {
     if (m_prg_api_p->GetSectorFlag(SectorOp::PROGRAM_SECTOR_OP, block))
     {
-      //Collect data socket by socket
+      //gang mode per ICU-S status: each partition with its own ICU-S region size
       failed_skt_mask = 0;
       WORD socket_mask = LM_Phapi::Get()->ActiveDUTMaskGet();
-      m_current_op_mode = DeviceOperation::READ;
-      for (nDUT = MAX_SOCKET_NUM - 1; nDUT >= 0; nDUT--)
+      for (icuStatus = ICU_S_RESPONSIVE_VALID; icuStatus <= ICU_S_RESPONSIVE_INVALID; icuStatus++)
       {
-        // check only active sockets
-        skt_stat = m_prg_api_p->SocketStatusGet(SocketNumChange(nDUT + 1));
-        if (skt_stat == SOCKET_ENABLE)
+        skt_mask = Get_ICU_S_SocketMask(icuStatus);
+        if (skt_mask == 0)
+          continue;
+        LM_Phapi::Get()->SetGangSktMode(skt_mask);
+        for (block = m_DF_block_nr; block < m_sector_quantity; block++)
         {
-          // activate this one socket for reading
-          // Note: ALL OTHER SOCKETS WILL BE DISABLED
-          skt_mask = 1 << nDUT;
-          LM_Phapi::Get()->SetSingleSktMode((WORD)(nDUT + 1));
-          do
-          {
-
-            if (m_ICU_S_Status[nDUT] == ICU_S_RESPONSIVE_INVALID)
-            {
-              if (OPERATION_OK != Verify_DataFlash_Area(block, 0))
-                failed_skt_mask |= skt_mask;
-            } //-- OF if(m_ICU_S_Status[nDUT])
-            else if (m_ICU_S_Status[nDUT] == ICU_S_RESPONSIVE_VALID)
-            {
-              if (OPERATION_OK != Verify_DataFlash_Area(block, m_ICU_S_RegionSize))
-                failed_skt_mask |= skt_mask;
-            }
-
-          } while (++block < m_sector_quantity && verify_stat == OPERATION_OK);
-
-          if (failed_skt_mask & skt_mask)
+          if (!m_prg_api_p->GetSectorFlag(SectorOp::PROGRAM_SECTOR_OP, block))
             continue;
-
-        } //-- OF if (skt_stat==SOCKET_ENABLE)
-      }   //-- OF for (nDUT=MAX_SOCKET_NUM-1; nDUT>=0; nDUT--)
-      // Re-Enable all enabled sockets
-      LM_Phapi::Get()->SetGangSktMode(socket_mask);
-      m_current_op_mode = saved_current_op_mode;
+          if (OPERATION_OK != Verify_DataFlash_Area(block, (icuStatus == ICU_S_RESPONSIVE_VALID) ? m_ICU_S_RegionSize : 0))
+          {
+            failed_skt_mask |= skt_mask;
+            break;
+          }
+        }
+        failed_skt_mask |= skt_mask & ~LM_Phapi::Get()->ActiveDUTMaskGet(); //disabled by MisCompare() within the pass
+      }
+      // Re-Enable the enabled sockets, which did not fail
+      LM_Phapi::Get()->SetGangSktMode(socket_mask & ~failed_skt_mask);
 
       // disable the DUT
       if (CompareFailed(failed_skt_mask))
@@ -3475,9 +4906,7 @@ C_RV40F::DEV_STAT_E C_RV40F::Secure()
   volatile BYTE *srcbase = (volatile BYTE *)m_srcdata_bp;
   bool optionDataBlockHasSN;
   DEV_STAT_E secure_stat = OPERATION_OK;
-  SOCKET_STATUS_E skt_stat;
   BYTE skt_mask, failed_skt_mask;
-  int nDUT;
 
   m_current_op_mode = DeviceOperation::SECURE;
   //This procedure is called last, thus it is in charge of
@@ -3586,37 +5015,24 @@ C_RV40F::DEV_STAT_E C_RV40F::Secure()
     }
     else
     {
-      //Collect data socket by socket
+      //validate the sockets with invalid ICU-S area in gang mode
       failed_skt_mask = 0;
       WORD socket_mask = LM_Phapi::Get()->ActiveDUTMaskGet();
-      m_current_op_mode = DeviceOperation::READ;
-      for (nDUT = MAX_SOCKET_NUM - 1; nDUT >= 0; nDUT--)
+      skt_mask = Get_ICU_S_SocketMask(ICU_S_RESPONSIVE_INVALID);
+      if (skt_mask)
       {
-        // check only active sockets
-        skt_stat = m_prg_api_p->SocketStatusGet(SocketNumChange(nDUT + 1));
-        if ((skt_stat == SOCKET_ENABLE) && (m_ICU_S_Status[nDUT] == ICU_S_RESPONSIVE_INVALID))
+        LM_Phapi::Get()->SetGangSktMode(skt_mask);
+        WriteCmdBuffer(0, ICU_S_VALIDATE_CMD);
+        if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 1) ||
+            false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
         {
-          // activate this one socket for reading
-          // Note: ALL OTHER SOCKETS WILL BE DISABLED
-          skt_mask = 1 << nDUT;
-          LM_Phapi::Get()->SetSingleSktMode((WORD)(nDUT + 1));
-
-          WriteCmdBuffer(0, ICU_S_VALIDATE_CMD);
-          if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 1))
-          {
-            failed_skt_mask |= skt_mask;
-            secure_stat = SECURE_ERR;
-          }
-          if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
-          {
-            failed_skt_mask |= skt_mask;
-            secure_stat = SECURE_ERR;
-          }
-        } //-- OF if (skt_stat==SOCKET_ENABLE)
-      }   //-- OF for (nDUT=MAX_SOCKET_NUM-1; nDUT>=0; nDUT--)
-      // Re-Enable all enabled sockets
-      LM_Phapi::Get()->SetGangSktMode(socket_mask);
-      m_current_op_mode = DeviceOperation::SECURE;
+          failed_skt_mask |= skt_mask;
+          secure_stat = SECURE_ERR;
+        }
+        failed_skt_mask |= skt_mask & ~LM_Phapi::Get()->ActiveDUTMaskGet(); //disabled by MisCompare() within the pass
+      }
+      // Re-Enable the enabled sockets, which did not fail
+      LM_Phapi::Get()->SetGangSktMode(socket_mask & ~failed_skt_mask);
 
       // disable the DUT
       if (CompareFailed(failed_skt_mask))
@@ -4022,15 +5438,13 @@ C_RV40F_P1XC::DEV_STAT_E C_RV40F_P1XC::Secure()
   PRINTF("C_RV40F_P1XC::Secure()\n"); // debug statements
 #endif
 
-  DWORD i, addrCnt;
+  DWORD i;
   WORD cfgAddr;
   BYTE data_buffer[PROT_LENGTH];
   volatile BYTE *srcbase = (volatile BYTE *)m_srcdata_bp;
   bool optionDataBlockHasSN;
   DEV_STAT_E secure_stat = OPERATION_OK;
-  SOCKET_STATUS_E skt_stat;
   BYTE skt_mask, failed_skt_mask;
-  int nDUT;
 
   m_current_op_mode = DeviceOperation::SECURE;
   //This procedure is called last, thus it is in charge of
@@ -4117,12 +5531,7 @@ C_RV40F_P1XC::DEV_STAT_E C_RV40F_P1XC::Secure()
       //program Option-bytes (OPBT)
       for (BYTE opbtSel = 0; opbtSel < 4; opbtSel++)
       {
-        for (addrCnt = 0; addrCnt < 16; addrCnt++)
-        {
-          if (GetDataFromRam_8Bit(OPBT_OFFSET(0) + opbtSel * 16 + addrCnt, (DWORD)m_srcdata_bp) != 0xFF)
-            break;
-        }
-        if (addrCnt == 16)
+        if (MemScan_AllEqual(&m_srcdata_bp[OPBT_OFFSET(0) + opbtSel * 16], 16, 0xFF))
           continue;
 
         WriteCmdBuffer(0, OPTION_SET_CMD);
@@ -4155,37 +5564,24 @@ C_RV40F_P1XC::DEV_STAT_E C_RV40F_P1XC::Secure()
       }
       else
       {
-        //Collect data socket by socket
+        //validate the sockets with invalid ICU-S area in gang mode
         failed_skt_mask = 0;
         WORD socket_mask = LM_Phapi::Get()->ActiveDUTMaskGet();
-        m_current_op_mode = DeviceOperation::READ;
-        for (nDUT = MAX_SOCKET_NUM - 1; nDUT >= 0; nDUT--)
+        skt_mask = Get_ICU_S_SocketMask(ICU_S_RESPONSIVE_INVALID);
+        if (skt_mask)
         {
-          // check only active sockets
-          skt_stat = m_prg_api_p->SocketStatusGet(SocketNumChange(nDUT + 1));
-          if ((skt_stat == SOCKET_ENABLE) && (m_ICU_S_Status[nDUT] == ICU_S_RESPONSIVE_INVALID))
+          LM_Phapi::Get()->SetGangSktMode(skt_mask);
+          WriteCmdBuffer(0, ICU_S_VALIDATE_CMD);
+          if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 1) ||
+              false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
           {
-            // activate this one socket for reading
-            // Note: ALL OTHER SOCKETS WILL BE DISABLED
-            skt_mask = 1 << nDUT;
-            LM_Phapi::Get()->SetSingleSktMode((WORD)(nDUT + 1));
-            
-            WriteCmdBuffer(0, ICU_S_VALIDATE_CMD);
-            if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 1))
-            {
-              failed_skt_mask |= skt_mask;
-              secure_stat = SECURE_ERR;
-            }
-            if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
-            {
-              failed_skt_mask |= skt_mask;
-              secure_stat = SECURE_ERR;
-            }
-          } //-- OF if (skt_stat==SOCKET_ENABLE)
-        }   //-- OF for (nDUT=MAX_SOCKET_NUM-1; nDUT>=0; nDUT--)
-        // Re-Enable all enabled sockets
-        LM_Phapi::Get()->SetGangSktMode(socket_mask);
-        m_current_op_mode = DeviceOperation::SECURE;
+            failed_skt_mask |= skt_mask;
+            secure_stat = SECURE_ERR;
+          }
+          failed_skt_mask |= skt_mask & ~LM_Phapi::Get()->ActiveDUTMaskGet(); //disabled by MisCompare() within the pass
+        }
+        // Re-Enable the enabled sockets, which did not fail
+        LM_Phapi::Get()->SetGangSktMode(socket_mask & ~failed_skt_mask);
 
         // disable the DUT
         if (CompareFailed(failed_skt_mask))
@@ -4311,43 +5707,30 @@ C_RV40F_Kimball::DEV_STAT_E C_RV40F_Kimball::Erase_CF_Block()
   PRINTF("C_RV40F_Kimball::Erase_CF_Block()\n"); // debug statements
 #endif
 
-  DWORD address, startaddress_in_device;
   bool fResetReq = false;
+  DWORD start_ms;
   DEV_STAT_E erase_stat = OPERATION_OK;
 
-  m_current_op_mode = DeviceOperation::ERASE;
-
-  if (false == DeviceInit())
+  if (false == BeginOperation(DeviceOperation::ERASE))
     return BLOCK_ERASE_ERR;
 
-  WORD block = 0;
-  do
-  {
-    // see if block has to be erased
-    if (m_prg_api_p->GetSectorFlag(SectorOp::ERASE_SECTOR_OP, block))
-    {
-      if (block == m_option_data_block || block >= m_DF_block_nr)
-        continue;
-
-      startaddress_in_device = m_devsectors_p[block].begin_address;
-      PRINTF("C_RV40F_Kimball::currently erasing block %d\n", block);
-
-      WriteCmdBuffer(ERASE_CMD, startaddress_in_device, 0);
-
-      if (false == SendFrame(SOH, ETX, GetCmdBufferP(), 5))
-        return WSM_BUSY_ERR;
-
-      if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
-      {
-        erase_stat = BLOCK_ERASE_ERR;
-        PRINTF("C_RV40F_Kimball::Erasing failed in block %d\n", block);
-      }
-
-      // check for any system events
-      if (m_prg_api_p->SysEvtChk())
-        return HARDWARE_ERR; // O.C. or Adapter change - return immediately
-    }                        // end of if 'sector' was to be programmed
-  } while (++block < m_sectors2load && erase_stat == OPERATION_OK);
+  memset(m_block_unchanged_p, false, m_sector_quantity * sizeof(bool)); //blocks are loaded with the descriptor code, not with the image
+  m_fUnchangedValid = false;
+  m_erase_cmds_saved = 0;
+  m_erase_blocks = 0;
+  m_erase_ms = 0;
+  start_ms = GetTimeMs();
+
+  erase_stat = EraseCFBlocks(m_sectors2load);
+  if (erase_stat == WSM_BUSY_ERR || erase_stat == HARDWARE_ERR)
+    return erase_stat;
+
+  if (m_fRangeErase && m_erase_blocks)
+  { //estimated time saved: saved commands * measured erase time per block
+    sprintf(msgbuff, "Range erase: %d ERASE commands saved, approx. %d ms saved (%d ms per block), erase time %d ms.",
+            m_erase_cmds_saved, m_erase_cmds_saved * m_erase_ms / m_erase_blocks, m_erase_ms / m_erase_blocks, GetTimeMs() - start_ms);
+    m_prg_api_p->Write2EventLog(msgbuff);
+  }
 
   if (fResetReq)
     ResetToProgrammingMode();
@@ -4383,9 +5766,7 @@ C_RV40F_Kimball::DEV_STAT_E C_RV40F_Kimball::Program_CF_Block()
   DWORD areaSize;
   WORD blockSize;
 
-  m_current_op_mode = DeviceOperation::PROGRAM;
-
-  if (false == DeviceInit())
+  if (false == BeginOperation(DeviceOperation::PROGRAM))
     return PROGRAM_ERR;
 
   WORD block = 0;
@@ -4425,6 +5806,8 @@ C_RV40F_Kimball::DEV_STAT_E C_RV40F_Kimball::Program_CF_Block()
 
         if (false == SendFrame(SOD, frameEndType, (BYTE *)(srcbase + address), blockSize, PROGRAM_CMD))
           return WSM_BUSY_ERR;
+        if (frameEndType == ETB) //stage the next page while the device is busy
+          PreloadFrame(SOD, (BYTE *)(srcbase + address + blockSize), blockSize, PROGRAM_CMD);
 
         if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
         {
@@ -4467,9 +5850,7 @@ C_RV40F_Kimball::DEV_STAT_E C_RV40F_Kimball::Verify_CF_Block()
   WORD block;
   DEV_STAT_E verify_stat = OPERATION_OK;
 
-  m_current_op_mode = DeviceOperation::VERIFY;
-
-  if (false == DeviceInit())
+  if (false == BeginOperation(DeviceOperation::VERIFY))
     return VERIFY_ERR;
 
   //blockwise operation
@@ -4503,6 +5884,8 @@ C_RV40F_Kimball::DEV_STAT_E C_RV40F_Kimball::Verify_CF_Block()
 
         if (false == SendFrame(SOD, frameEndType, (BYTE *)(srcbase + address), MAX_PAGE_SIZE, VERIFY_CMD))
           return WSM_BUSY_ERR;
+        if (frameEndType == ETB) //stage the next page while the device is busy
+          PreloadFrame(SOD, (BYTE *)(srcbase + address + MAX_PAGE_SIZE), MAX_PAGE_SIZE, VERIFY_CMD);
 
         if (false == GetDataFrame(ETX, GetCmdBufferP(), CHECK_ST1, CHECK_ST1))
         {
@@ -4615,11 +5998,11 @@ C_RV40F_Kimball::DEV_STAT_E C_RV40F_Kimball::Secure()
   }
   MicroSecDelay(100);
   if (LOBYTE(m_devparms_p->reserved4))
-    DELAY_MS(LOBYTE(m_devparms_p->reserved4) * 100); //wait for regulator stabilisation
+    DELAY_MS(LOBYTE(m_devparms_p->reserved4) * 100); //wait for regulator stabilisation (SO does not track the core supply)
 
   if (m_prg_api_p->PinExists(POWERGOOD_PIN))
     m_prg_api_p->PinSet(POWERGOOD_PIN, LOGIC_1);
-  DELAY_MS(50);
+  WaitPowerSettled("PowerUp - power good", LOGIC_1, 50);
 
   m_prg_api_p->PinSet(_RESET_PIN, LOGIC_1);
   MicroSecDelay(1200);
@@ -4632,8 +6015,9 @@ C_RV40F_Kimball::DEV_STAT_E C_RV40F_Kimball::Secure()
 
   ResetToProgrammingMode();
 
-  if (m_prg_api_p->SysEvtChk())
+  if (m_fSysEvtPending || m_prg_api_p->SysEvtChk()) //event eventually read during WaitPowerSettled()
     PRINTF(" OC @ line %d\n", __LINE__);
+  m_fSysEvtPending = false;
 
   secure_stat = Erase_CF_Block();
   if (secure_stat != OPERATION_OK)
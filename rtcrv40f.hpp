@@ -20,6 +20,30 @@
 // 						5.4   : 08/13/18 - added get_ICU_S_RegionSize(void)
 //	     6.1    : 02/08/21 - added function WaituntillDevcieReady.
 //	     7.0    : 03/02/21 - added function socketsimilaritycheck for ICUS supported devices.
+//	     7.1    : 10/18/26 - added BuildFrame(...): frames are transmitted as one bulk shift.
+//	     7.2    : 10/18/26 - added LoadSequencer(...): sequencer header built per frame.
+//	     7.3    : 10/18/26 - added CompareFrame(...): bulk compare of a received frame.
+//	     7.4    : 10/18/26 - added PreloadFrame(...): double-buffered sequencer RAM.
+//	     7.5    : 10/18/26 - added DataSum(...), GetSectorCRC(...): job level checksum cache.
+//	     7.7    : 10/18/26 - WaitUntilDeviceReady(...) with ms deadline; added wait time histograms.
+//	     7.8    : 10/18/26 - added m_fStartupFpgaClock: FPGA shift clock in startup mode.
+//	     7.9    : 10/18/26 - added ReceiveFrame(...): frame reception in one transfer.
+//	     7.10   : 10/18/26 - added ReceiveFrameToImage(...): Read() without intermediate buffer.
+//	     7.11   : 10/18/26 - added EXTENT_T, BuildExtents(), ScanExtents(...), FindExtent(...).
+//	     7.12   : 10/18/26 - added ProgramRange(...).
+//	     7.14   : 10/18/26 - added m_fCF_skip0xFF, m_CF_data_extent_p, ProgramExtents(...).
+//	     7.15   : 10/18/26 - added HYBRID_VERIFY: CompareDataFrame(...), CheckSectorCRC(...), LocalizeCRCFail(...), m_crc_fail_p.
+//	                         C_RV40F_Kimball keeps the page by page verify: its code is not part of the image (no CRC cache).
+//	     7.16   : 10/18/26 - added m_fIncremental, m_block_unchanged_p, FindUnchangedBlocks().
+//	     7.17   : 10/18/26 - added m_fRangeErase, m_erase_cmds_saved, m_erase_blocks, m_erase_ms, TryRangeErase(...), EraseCFBlocks(...).
+//	     7.19   : 10/18/26 - added GangCompareCmd(...), check_length for CompareDataFrame(...).
+//	     7.20   : 10/18/26 - added MODE_ENTRY_CACHE_T, m_cached_mode_entry_wait, Load/SaveModeEntryCache(...).
+//	     7.21   : 10/18/26 - added m_fPowerSettleDetect, WaitPowerSettled(...).
+//	     7.22   : 10/18/26 - added SESSION_T m_session, BeginOperation(...), RecoverSession(), ReportSession().
+//	     7.23   : 10/18/26 - added SendBlankCheckCmd(...).
+//	     7.24   : 10/18/26 - added m_fReadCompareAll, CompareReadRange(...), CompareBlankRange(...), CompareBlockToImage(...),
+//	                         GetBlockReadRange(...), CompareSocketsToImage(); fValid for MarkImageValid(...).
+//	     7.25   : 10/18/26 - added markerUnit to ScanExtents(...), VerifyDFRange(...).
 //----------------------------------------------------------------------------
 #ifndef RTCRV40F_HPP
 #define RTCRV40F_HPP
@@ -63,14 +87,21 @@ typedef BYTE FRAMEEND_T;
 
 #define COMMODE_CSI_SEL_CNT   3
 #define STARTUP_SCI_FREQUENCY 10000     //the serial clock at startup - set it lower than 40000 to make it symmetrical (50% duty cycle), otherwise communication fails
-#define DEFAULT_TIMEOUT       2000000   //~ 2s generic timeout
-#define ERASE_TIMEOUT         45000000  //~ 45 erase timeout
+#define DEFAULT_TIMEOUT_MS    2000      //generic timeout
+#define ERASE_TIMEOUT_MS      45000     //erase timeout
+#define READY_SPIN_POLLS      64        //SO polls without delay, before the poll interval is increased
+#define READY_BACKOFF_MAX_US  512       //max. delay between two SO polls (long waits: then once per ms)
+#define WAIT_HIST_CMDS        0x80      //wait time histogram per command (cmd & 0x7F)
+#define WAIT_HIST_BUCKETS     16        //log2 ms buckets
+#define SETTLE_STABLE_MS      5         //power settle detection: SO level and no over-current for this time
 
 #define LONG_DELAY  true
 
 //Verify types
 #define CHECKSUM_VERIFY  1
 #define DATA_VERIFY      2
+#define HYBRID_VERIFY    3  //CRC per block, failing blocks are verified page by page afterwards
+#define HYBRID_LOG_PAGES 8  //failing pages logged per block
 
 //STATUS byte counts
 #define CHECK_ST1      1
@@ -80,6 +111,12 @@ typedef BYTE FRAMEEND_T;
 #define MIN_PAGE_SIZE        256  //Code flash
 #define MAX_PAGE_SIZE       1024
 #define COM_BUFFER_SIZE	    1030 // 1 + 2(LN) + 1 + 1024 + 1(CS) + 1(ETX)
+#define SEQ_DATA_BANKS       256  //sequencer banks 1..256 hold up to MAX_PAGE_SIZE data bytes
+#define SEQ_MIN_FRAME_SIZE    32  //shorter data frames are sent by the wiggler only
+#define SEQ_REGIONS            2  //ping-pong: one region is shifted, the other one is loaded
+#define SEQ_REGION_BASE(region) ((DWORD)(region) * 0x200)  //first bank (header) of a sequencer region
+#define COMPARE_GRANULE       128 //bytes per SerialCompare in CompareFrame(): resolution of the first failing offset
+#define NO_FAIL_OFFSET    0xFFFF
 
 #define DEVICE_NAME_LENGTH    16
 #define MESSAGE_LENGTH        80
@@ -87,8 +124,10 @@ typedef BYTE FRAMEEND_T;
 
 #define DF_START_IN_IMAGE    0x02000000
 #define DF_MARKER_OFFSET     0x00100000 //for RV40F data flash
+#define CF_PAGES_IN_IMAGE    (DF_START_IN_IMAGE / MAX_PAGE_SIZE) //1kB pages below the data flash
 
 #define CF_MARKER_OFFSET     0x02180000 //1 byte per 256 CF bytes -> 16MB requires 64kB marker area
+#define SCAN_NOT_0xFF        0xFFFFFFFF //ScanExtents(): no marker area, scan the data for units != 0xFF
 
 
 //HEX-file map defines (partly based on RPI/Consolidated-HEX requirements) 
@@ -144,6 +183,8 @@ typedef BYTE FRAMEEND_T;
 #define PROT_BYTE_ERASPROT_MSK  0x20
 
 #define MODE_ENTRY_DELAY_MAXCNT   5
+#define MODE_ENTRY_CACHE_FILE     "rv40f_timing.dat" //mode entry delays found per device type, kept over power cycles
+#define MODE_ENTRY_CACHE_MAXCNT   32
 
 #define UNKNOWN                 0xFE
 
@@ -184,6 +225,23 @@ struct DEVICE_DESCRIPTOR_T
 	WORD  code_length;
 	int 	app_runtime;
 };
+struct MODE_ENTRY_CACHE_T   // record of MODE_ENTRY_CACHE_FILE
+{
+	BYTE  TYPE[8];      //device type code (without frequencies)
+	DWORD delay;        //reset_H_flmd0_pulse_start_wait which worked last time
+};
+struct SESSION_T            // programming mode session: power up to power down, kept over all operations of a job
+{
+	WORD operations;      //operations started (BeginOperation)
+	WORD inits_skipped;   //operations, which reused the initialized target (m_fTarget_initialized, not new)
+	WORD recoveries;      //errors recovered with the target still in session (RecoverSession)
+	WORD mode_entries;    //resets to programming mode
+};
+struct EXTENT_T             // image range with data (marker 0x00)
+{
+	DWORD start;
+	DWORD size;
+};
 
 //forward declaration
 class StdWiggler;   
@@ -257,6 +315,11 @@ class C_RV40F : public FlashAlg2
 		StdWiggler* m_fpga_p;     
 
 		bool m_fpga_speedup_supported;   //true only, when the appropriate FPGA is loaded
+		DWORD m_seq_header[SEQ_REGIONS];    //frame header currently loaded in bank 0 of the region
+		DWORD m_seq_last_bank[SEQ_REGIONS]; //bank of the region currently flagged as last
+		BYTE  m_seq_region;                 //region used by the last SendFrame()
+		const BYTE* m_seq_staged_p;         //data frame staged in the idle region (PreloadFrame), NULL: none
+		WORD  m_seq_staged_length;
 
 		PRM_T* m_tRV40F_Param_p;    //pointer to specific device param struct
 		ALG_CODE* m_tBoot_code_p;  //pointer to bootloader code
@@ -264,10 +327,22 @@ class C_RV40F : public FlashAlg2
 		int m_sector_quantity; 
 		BYTE m_akt_skt_msk;
 		bool m_fTarget_initialized;
+		bool m_fGangInitialized;    //DeviceInit() ran in gang mode (not READ): all enabled sockets are initialized
+		SESSION_T m_session;
 		bool m_fStartupMode;
+		bool m_fStartupFpgaClock; //startup frames are shifted by the FPGA (special feature "Startup - FPGA shift clock")
+		bool m_fPowerSettleDetect; //power rails are polled until stable, configured delays are the ceiling
+		bool m_fSysEvtPending;     //system event read by WaitPowerSettled(), not yet reported
+		bool m_fReadCompareAll; //after Read() the read image is compared with all enabled sockets in gang mode
 		BYTE m_VerifyType;
 		bool m_fDF_filled0xFF; //for devices with DF unit = 16 the user can select if undefined addreses are filled up with 0xFF
 		bool m_fCF_filled0xFF; //The user can select if undefined addreses are filled up with 0xFF in code flash
+		bool m_fCF_skip0xFF;   //fill-up mode: 256 byte units with 0xFF only are not programmed in erased blocks
+		bool m_fIncremental;   //CF blocks with matching CRC on all sockets are neither erased nor programmed
+		bool m_fRangeErase;    //contiguous blocks are erased with one ERASE command (start + end address)
+		WORD m_erase_cmds_saved; //ERASE commands saved by range erase in the current operation
+		WORD m_erase_blocks;     //blocks erased in the current operation (by range or block by block)
+		DWORD m_erase_ms;        //time of the block erase commands in the current operation
 
 		BYTE  m_op_frequency;  //operation frequency (XTAL), unit 100kHz
 		DWORD m_sys_clk;       //system frequency (XTAL x PLL)   
@@ -277,6 +352,7 @@ class C_RV40F : public FlashAlg2
 		
 		WORD m_option_data_block; //nr of the option block
 		DWORD m_reset_H_flmd0_pulse_start_wait;
+		DWORD m_cached_mode_entry_wait; //delay loaded from MODE_ENTRY_CACHE_FILE, 0: none
 
 		//device special features
 		DWORD m_optionSupportedByDev;
@@ -299,9 +375,30 @@ class C_RV40F : public FlashAlg2
 		WORD m_id_len;
 		WORD m_signature_len;
 
+		//job level cache of image checksums (see DataSum, GetSectorCRC)
+		BYTE*  m_page_sum_p;          //byte sum of each 1kB CF page
+		bool*  m_page_sum_valid_p;
+		DWORD* m_sector_crc_p;        //CRC32 of each block
+		bool*  m_sector_crc_valid_p;
+		SOCKET_STATUS_T* m_crc_fail_p; //HYBRID_VERIFY: sockets with CRC mismatch per block
+		bool*  m_block_unchanged_p;    //m_fIncremental: device block equals image block on all sockets
+		bool   m_fUnchangedValid;      //m_block_unchanged_p was determined by Erase() of the current part
+
+		//sorted image ranges with data (see BuildExtents)
+		EXTENT_T* m_CF_extent_p;
+		DWORD     m_CF_extent_cnt;
+		EXTENT_T* m_DF_extent_p;
+		DWORD     m_DF_extent_cnt;
+		EXTENT_T* m_CF_data_extent_p; //CF ranges != 0xFF (m_fCF_skip0xFF only)
+		DWORD     m_CF_data_extent_cnt;
+
 	private:  //parameter
 		BYTE m_cmd_buffer[CMD_BUFFER_SIZE];
 		BYTE m_comm_buffer[COM_BUFFER_SIZE];
+		BYTE m_tx_buffer[COM_BUFFER_SIZE];   //complete transmit frame, shifted out at once
+		BYTE m_cmp_mask[COM_BUFFER_SIZE];    //compare mask for the expected frame in m_tx_buffer
+		WORD m_first_fail_offset[MAX_SOCKET_NUM]; //per socket: frame offset of the first failing granule
+		DWORD m_wait_hist[WAIT_HIST_CMDS][WAIT_HIST_BUCKETS]; //SO ready wait times per command
 
 	//methods
 	public:
@@ -334,17 +431,36 @@ class C_RV40F : public FlashAlg2
 		void WriteCmdBuffer(const BYTE cmd, const DWORD param1, const DWORD param2);
 		void WaitLoop(const DWORD delay_us);
 		bool GetSockets_ICU_S_Status();
+		BYTE Get_ICU_S_SocketMask(const int icuStatus);
 
 		virtual void DoPowerUp (void); 
 		virtual void DoPowerDown (void); 
 		virtual void ResetToProgrammingMode(void);
+		void LoadModeEntryCache(void);
+		void SaveModeEntryCache(const DWORD delay);
 		virtual DWORD GetDFAdressInDevice(DWORD address);
 		virtual bool DeviceInit(void);
+		bool BeginOperation(const DEV_OP_E opMode);
+		void RecoverSession(void);
+		void ReportSession(void);
 		virtual int CheckFlashID(void);
 		int SerialWrite(const BYTE* data_p);
 		int SetFrequency(const BYTE chFrequency);
 		int InitializeFlashFirmware(ALG_CODE* tCode_p);
+		DEV_STAT_E ProgramRange(DWORD startInMem, DWORD startInDev, DWORD areaSize);
+		DEV_STAT_E ProgramExtents(const EXTENT_T* list_p, const DWORD cnt, DWORD startaddress, DWORD endaddress);
 		DEV_STAT_E VerifyArea(DWORD startInMem, DWORD startInDev, DWORD areaSize);
+		DEV_STAT_E CheckSectorCRC(const WORD block, SOCKET_STATUS_T* fail_p);
+		DEV_STAT_E LocalizeCRCFail(const WORD block, const SOCKET_STATUS_T failMask);
+		DEV_STAT_E CompareReadRange(DWORD startInMem, DWORD startInDev, DWORD areaSize, SOCKET_STATUS_T* diff_p, WORD* frames_p);
+		DEV_STAT_E CompareBlankRange(DWORD startInMem, DWORD startInDev, DWORD areaSize, SOCKET_STATUS_T* diff_p, WORD* frames_p);
+		DEV_STAT_E CompareBlockToImage(const WORD block, SOCKET_STATUS_T* diff_p, WORD* frames_p);
+		void GetBlockReadRange(const WORD block, DWORD* startaddress_p, DWORD* endaddress_p);
+		DEV_STAT_E CompareSocketsToImage(void);
+		DEV_STAT_E FindUnchangedBlocks(void);
+		bool TryRangeErase(const DWORD startaddress_in_device, const DWORD endaddress_in_device);
+		bool SendBlankCheckCmd(const WORD first, const WORD last);
+		DEV_STAT_E EraseCFBlocks(const WORD blockCount);
 		DEV_STAT_E RV_ProtBits(void);
 		virtual DEV_STAT_E RV_OPBT(void);
 		virtual DEV_STAT_E RV_IDCode(void);
@@ -352,6 +468,7 @@ class C_RV40F : public FlashAlg2
 		virtual DEV_STAT_E Erase_DataFlash_Area(DWORD DF_startaddress_in_device, DWORD DF_endaddress_in_device);
 		virtual DEV_STAT_E Program_DataFlash_Area(WORD Block, WORD ICU_S_RegionSize);
 		virtual DEV_STAT_E Verify_DataFlash_Area(WORD Block, WORD ICU_S_RegionSize);
+		DEV_STAT_E VerifyDFRange(DWORD startaddress, DWORD endaddress);
 		virtual DEV_STAT_E Erase_ICU_Area();
 
 
@@ -359,10 +476,32 @@ class C_RV40F : public FlashAlg2
 		virtual DEV_STAT_E RV_DeviceConfig(void);
 		DEV_STAT_E RV_BlockProtBits(BYTE blockProtCmd);
 	 
-		BYTE WaitUntilDeviceReady(DEV_OP_E opMode, const WORD pinLvl, DWORD timeout);
+		BYTE WaitUntilDeviceReady(DEV_OP_E opMode, const WORD pinLvl, DWORD timeout_ms);
+		DWORD GetTimeMs(void);
+		void RecordWaitTime(const BYTE cmd, DWORD wait_ms);
+		DWORD WaitPowerSettled(const char* step_p, const WORD pinLvl, const DWORD max_ms);
+		void ReportWaitHistogram(void);
+		WORD LoadSequencer(const BYTE region, const FRAMESTART_T startType, const BYTE* buffer_p, const WORD length, BYTE includeACK);
+		bool IsSequencerFrame(const BYTE* buffer_p, const WORD length, BYTE includeACK);
+		void PreloadFrame(const FRAMESTART_T startType, const BYTE* buffer_p, const WORD length, BYTE includeACK);
+		WORD BuildFrame(const FRAMESTART_T startType, const FRAMEEND_T endType, const BYTE* buffer_p, const WORD length, BYTE includeACK);
 		int SendFrame(const FRAMESTART_T startType, const FRAMEEND_T endType, const BYTE* buffer_p, const WORD length, BYTE includeACK = 0x00);
+		BYTE DataSum(const BYTE* buffer_p, const WORD length);
+		DWORD GetSectorCRC(const WORD block);
+		void InvalidateImageCache(void);
+		SOCKET_STATUS_T CompareFrame(const WORD frameLength);
+		bool MisCompareFrame(const SOCKET_STATUS_T socket_stat, const DWORD baseAddress, const WORD headerLength);
+		SOCKET_STATUS_T CompareDataFrame(const FRAMEEND_T endType, BYTE* buffer_p, const WORD length, const WORD check_length, BYTE includeACK = 0x00, DWORD timeout_ms = DEFAULT_TIMEOUT_MS);
+		SOCKET_STATUS_T GangCompareCmd(const BYTE cmd, BYTE* expected_p, const WORD length, const WORD check_length);
 		int GetDataFrame(const FRAMEEND_T endType, BYTE* buffer_p, const WORD length, const WORD check_length, BYTE includeACK = 0x00, bool fLongWait = false);
+		int ReceiveFrameHeader(BYTE* frame_p, const WORD headerLength, WORD* length_p, BYTE* checksum_p, DWORD timeout_ms = DEFAULT_TIMEOUT_MS);
+		int ReceiveFrame(BYTE* frame_p, WORD* length_p, DWORD timeout_ms = DEFAULT_TIMEOUT_MS);
+		int ReceiveFrameToImage(const BYTE ackCode, BYTE* data_p, const DWORD dataSpace, WORD* length_p);
+		void MarkImageValid(const WORD block, const DWORD startaddress, const DWORD size, const bool fValid = true);
 		int ReadDataFrame(BYTE* buffer_p);
+		void BuildExtents(void);
+		DWORD ScanExtents(EXTENT_T* list_p, const DWORD markerOffset, const DWORD markerUnit, const DWORD unit, const WORD firstBlock, const WORD lastBlock);
+		DWORD FindExtent(const EXTENT_T* list_p, const DWORD cnt, const DWORD address);
 		bool DF_IsAreaEmpty(DWORD startAddress, DWORD areaSize);
 		int VerifyDFblock(const FRAMEEND_T endType, BYTE* buffer_p, WORD pageSZ);
 		bool CF_IsAreaEmpty(DWORD startAddress, DWORD areaSize);